@@ -0,0 +1,42 @@
+//
+//  LegacyEuclideanClusterer.hpp
+//  clusterBenchmark
+
+#ifndef LegacyEuclideanClusterer_hpp
+#define LegacyEuclideanClusterer_hpp
+
+#include <vector>
+#include <unordered_map>
+#include "dbscan.hpp"
+
+// EuclideanClusterer as it was before the point grid and the worker bands, kept
+// only to measure against: a hash map of cells rebuilt every scan, a vector of
+// neighbors per point and a vector per cluster
+class LegacyEuclideanClusterer {
+public:
+	float tolerance = 150.0f;  // max distance between points in the same cluster (mm)
+	int   minPoints = 3;       // minimum points to form a cluster
+
+	std::vector<std::vector<int>> cluster(const std::vector<point2>& points);
+
+private:
+	// spatial hash helpers
+	using CellKey = std::pair<int, int>;
+
+	struct CellKeyHash {
+		size_t operator()(const CellKey& k) const {
+			// combine two ints into a single hash
+			size_t h1 = std::hash<int>{}(k.first);
+			size_t h2 = std::hash<int>{}(k.second);
+			return h1 ^ (h2 * 2654435761u);
+		}
+	};
+
+	CellKey cellFor(const point2& p, float cellSize) const;
+	std::vector<int> neighborsOf(int idx,
+								 const std::vector<point2>& points,
+								 const std::unordered_map<CellKey, std::vector<int>, CellKeyHash>& grid,
+								 float cellSize) const;
+};
+
+#endif /* LegacyEuclideanClusterer_hpp */
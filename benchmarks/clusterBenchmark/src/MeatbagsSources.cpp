@@ -0,0 +1,9 @@
+//
+//  MeatbagsSources.cpp
+//  clusterBenchmark
+
+// the parts of meatbags EuclideanClusterer needs, compiled here rather than adding
+// src/BlobTracking whole, which would pull in the rest of the app with it
+#include "WorkerPool.cpp"
+#include "PointGrid.cpp"
+#include "EuclideanClusterer.cpp"
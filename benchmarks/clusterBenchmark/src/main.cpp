@@ -0,0 +1,145 @@
+//
+//  main.cpp
+//  clusterBenchmark
+
+#include <random>
+#include "ofMain.h"
+#include "EuclideanClusterer.hpp"
+#include "LegacyEuclideanClusterer.hpp"
+#include "WorkerPool.hpp"
+#include "Benchmark.hpp"
+
+// clusters seeded scenes of 2k to 30k points with EuclideanClusterer, on one thread
+// and split into bands over a worker pool, and with the clusterer it replaced. all
+// three have to give the same clusters in the same order, each with the same indices
+
+// people as blobs of points, walls as dense lines that run across many grid rows
+// and so across band seams, and scattered noise. the points are ordered by their
+// angle from the middle of the room, as a sensor would have measured them
+static void makeScene(int numberPoints, int seed, PointBuffer& points, vector<point2>& legacyPoints) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> room(-10000.0f, 10000.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::normal_distribution<float> body(0.0f, 80.0f);
+
+	vector<point2> scene;
+	scene.reserve(numberPoints);
+
+	int numberWallPoints = numberPoints / 4;
+	int numberNoisePoints = numberPoints / 10;
+	int numberPersonPoints = numberPoints - numberWallPoints - numberNoisePoints;
+
+	for (int i = 0; i < numberWallPoints; i++) {
+		int wall = i % 4;
+		float along = room(random);
+		float across = (wall < 2 ? -9500.0f : 9500.0f) + body(random) * 0.1f;
+		if (wall % 2 == 0) scene.push_back({ along, across });
+		else scene.push_back({ across, along });
+	}
+
+	// about 60 points a person
+	float centerX = 0, centerY = 0;
+	for (int i = 0; i < numberPersonPoints; i++) {
+		if (i % 60 == 0) {
+			centerX = room(random) * 0.9f;
+			centerY = room(random) * 0.9f;
+		}
+		scene.push_back({ centerX + body(random), centerY + body(random) });
+	}
+
+	for (int i = 0; i < numberNoisePoints; i++) {
+		scene.push_back({ room(random), room(random) });
+	}
+
+	std::sort(scene.begin(), scene.end(), [](const point2& a, const point2& b) {
+		return atan2(a.y, a.x) < atan2(b.y, b.x);
+	});
+
+	points.setCapacity(numberPoints);
+	points.clear();
+	for (const auto& point : scene) {
+		points.push(point.x, point.y, 0, PointBuffer::InFilter);
+	}
+	legacyPoints = scene;
+}
+
+static bool isSameClusters(const vector<vector<int>>& legacyClusters, const ClusterList& clusters) {
+	if ((int)legacyClusters.size() != clusters.size()) return false;
+
+	for (int c = 0; c < clusters.size(); c++) {
+		const vector<int>& legacyCluster = legacyClusters[c];
+		if ((int)legacyCluster.size() != clusters.getNumberPoints(c)) return false;
+		if (!std::equal(legacyCluster.begin(), legacyCluster.end(), clusters.getIndices(c))) return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && string(argv[1]) == "--help") {
+		std::cout
+			<< "usage: clusterBenchmark [options]\n"
+			<< "  --workers N         workers the bands are split over, besides the calling thread (3)\n"
+			<< "  --seed N            seed for the scenes (1)\n"
+			<< "  --iterations N      scans clustered per timing round (20)\n";
+		return 0;
+	}
+
+	int numberWorkers = ofToInt(Benchmark::getOption(argc, argv, "--workers", "3"));
+	int seed = ofToInt(Benchmark::getOption(argc, argv, "--seed", "1"));
+	int iterations = ofToInt(Benchmark::getOption(argc, argv, "--iterations", "20"));
+
+	WorkerPool workerPool;
+	workerPool.start(numberWorkers);
+
+	LegacyEuclideanClusterer legacy;
+	EuclideanClusterer serial(legacy.tolerance, legacy.minPoints);
+	EuclideanClusterer banded(legacy.tolerance, legacy.minPoints);
+	banded.setWorkerPool(&workerPool);
+
+	Benchmark::printRow({ "points", "clusters", "result", "legacy us", "serial us", "banded us", "serial speedup", "banded speedup", "legacy allocs", "banded allocs" });
+
+	bool haveAllMatched = true;
+	for (int numberPoints : { 2000, 5000, 10000, 20000, 30000 }) {
+		PointBuffer points;
+		vector<point2> legacyPoints;
+		makeScene(numberPoints, seed, points, legacyPoints);
+
+		vector<vector<int>> legacyClusters = legacy.cluster(legacyPoints);
+		ClusterList serialClusters, bandedClusters;
+		serial.cluster(points, serialClusters);
+		banded.cluster(points, bandedClusters);
+
+		bool isMatch = isSameClusters(legacyClusters, serialClusters) && isSameClusters(legacyClusters, bandedClusters);
+		if (!isMatch) {
+			ofLogError("clusterBenchmark") << numberPoints << " points cluster differently";
+			haveAllMatched = false;
+		}
+
+		Benchmark::Result legacyResult = Benchmark::measure(iterations, [&]() {
+			legacyClusters = legacy.cluster(legacyPoints);
+		});
+		Benchmark::Result serialResult = Benchmark::measure(iterations, [&]() {
+			serial.cluster(points, serialClusters);
+		});
+		Benchmark::Result bandedResult = Benchmark::measure(iterations, [&]() {
+			banded.cluster(points, bandedClusters);
+		});
+
+		Benchmark::printRow({
+			ofToString(numberPoints),
+			ofToString(legacyClusters.size()),
+			isMatch ? "same" : "different",
+			ofToString(legacyResult.nanoseconds / 1000.0, 0),
+			ofToString(serialResult.nanoseconds / 1000.0, 0),
+			ofToString(bandedResult.nanoseconds / 1000.0, 0),
+			ofToString(legacyResult.nanoseconds / serialResult.nanoseconds, 1) + "x",
+			ofToString(legacyResult.nanoseconds / bandedResult.nanoseconds, 1) + "x",
+			ofToString(legacyResult.allocations, 0),
+			ofToString(bandedResult.allocations, 0)
+		});
+	}
+
+	workerPool.stop();
+	return haveAllMatched ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+//
+//  Benchmark.cpp
+//  benchmarks
+
+#include "Benchmark.hpp"
+#include <new>
+#include <cstdlib>
+
+static std::atomic<uint64_t> numberAllocations{ 0 };
+
+// replaces the global allocator for the whole benchmark, sized deletes fall through to free
+void* operator new(size_t size) {
+	numberAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	std::free(pointer);
+}
+
+Benchmark::Result Benchmark::measure(int iterations, const std::function<void()>& task) {
+	iterations = std::max(iterations, 1);
+
+	for (int i = 0; i < iterations; i++) task();
+
+	vector<double> nanoseconds(ROUNDS);
+	uint64_t allocationsBefore = getNumberAllocations();
+
+	for (int round = 0; round < ROUNDS; round++) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) task();
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		nanoseconds[round] = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+	}
+
+	Result result;
+	result.allocations = (double)(getNumberAllocations() - allocationsBefore) / ((double)iterations * ROUNDS);
+
+	std::nth_element(nanoseconds.begin(), nanoseconds.begin() + ROUNDS / 2, nanoseconds.end());
+	result.nanoseconds = nanoseconds[ROUNDS / 2];
+	return result;
+}
+
+uint64_t Benchmark::getNumberAllocations() {
+	return numberAllocations.load(std::memory_order_relaxed);
+}
+
+void Benchmark::printRow(const vector<string>& columns) {
+	string row;
+	for (size_t i = 0; i < columns.size(); i++) {
+		string column = columns[i];
+		int width = i == 0 ? FIRST_COLUMN_WIDTH : COLUMN_WIDTH;
+		int padding = std::max(width - (int)column.size(), 1);
+		if (i == 0) row += column + string(padding, ' ');
+		else        row += string(padding, ' ') + column;
+	}
+	std::cout << row << std::endl;
+}
+
+string Benchmark::getOption(int argc, char* argv[], const string& name, const string& defaultValue) {
+	for (int i = 1; i + 1 < argc; i++) {
+		if (argv[i] == name) return argv[i + 1];
+	}
+	return defaultValue;
+}
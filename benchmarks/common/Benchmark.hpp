@@ -0,0 +1,37 @@
+//
+//  Benchmark.hpp
+//  benchmarks
+
+#ifndef Benchmark_hpp
+#define Benchmark_hpp
+
+#include <stdio.h>
+#include <functional>
+#include "ofMain.h"
+
+// times a task and counts the heap allocations it makes. every allocation in the
+// process goes through the counter, so only measure while nothing else is running
+class Benchmark {
+public:
+	struct Result {
+		double nanoseconds = 0;   // per call
+		double allocations = 0;   // per call
+	};
+
+	// one warm up round, then the median of ROUNDS rounds of iterations calls each
+	static Result measure(int iterations, const std::function<void()>& task);
+
+	static uint64_t getNumberAllocations();
+
+	// fixed width columns, the first one left aligned
+	static void printRow(const vector<string>& columns);
+
+	// reads --name value pairs, the rest of argv is left to the caller
+	static string getOption(int argc, char* argv[], const string& name, const string& defaultValue);
+
+	static constexpr int ROUNDS = 7;
+	static constexpr int COLUMN_WIDTH = 14;
+	static constexpr int FIRST_COLUMN_WIDTH = 24;
+};
+
+#endif /* Benchmark_hpp */
@@ -0,0 +1,149 @@
+//
+//  CorruptStream.cpp
+//  frameBenchmark
+
+#include "CorruptStream.hpp"
+
+const CorruptStream::SpeedMode CorruptStream::SPEED_MODES[5] = {
+	{ 1, 200, 75 },
+	{ 2, 150, 100 },
+	{ 3, 120, 125 },
+	{ 4, 100, 150 },
+	{ 5, 75, 200 }
+};
+
+void CorruptStream::generate(int numberFrames, const Faults& faults, int seed, const FrameCheck& frameCheck) {
+	random.seed(seed);
+	sequence = 0;
+	bytes.clear();
+	readSizes.clear();
+	intactFrames.clear();
+
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (int i = 0; i < numberFrames; i++) {
+		if (unit(random) < faults.garbage) addGarbage();
+		if (unit(random) < faults.falseHeaders) addFalseHeader();
+
+		// status polling answers about one in five frames
+		if (random() % 5 == 0) {
+			addControlResponse(unit(random) < faults.controlErrors, frameCheck);
+		} else {
+			addPointCloud(i % BLOCKS_PER_SCAN, unit(random) < faults.partials);
+		}
+	}
+
+	std::uniform_int_distribution<size_t> readSize(1, MAX_READ_SIZE);
+	for (size_t offset = 0; offset < bytes.size();) {
+		size_t length = std::min(readSize(random), bytes.size() - offset);
+		readSizes.push_back(length);
+		offset += length;
+	}
+}
+
+void CorruptStream::addPointCloud(int block, bool isTorn) {
+	const SpeedMode& mode = SPEED_MODES[(sequence / BLOCKS_PER_SCAN) % 5];
+	uint16_t frameLength = HEADER_LENGTH + mode.pointsPerBlock * 4 + 4;
+	uint16_t startAngle = 4500 + block * 1500;
+
+	vector<uint8_t> frame(frameLength, 0);
+	const uint8_t FRAME_HEADER[] = { 0x4D, 0x53, 0x02, 0xF4, 0xEB, 0x90 };
+	memcpy(frame.data(), FRAME_HEADER, sizeof(FRAME_HEADER));
+
+	putUint16(frame, 6, frameLength);
+	putUint16(frame, 8, startAngle);
+	putUint16(frame, 10, startAngle + (mode.pointsPerBlock - 1) * mode.angularResolution / 10);
+	putUint16(frame, 12, mode.angularResolution);
+	frame[14] = mode.infoType;
+	frame[15] = BLOCKS_PER_SCAN;
+	putUint16(frame, 16, block);
+	putUint16(frame, 18, (sequence >> 16) & 0xFFFF);
+	putUint16(frame, 20, sequence & 0xFFFF);
+	frame[24] = 1;
+	putUint16(frame, 31, 4200);
+	putUint16(frame, 33, 1200);
+
+	// distances in 2 mm units anywhere in range, so they hold start bytes too
+	for (int i = 0; i < mode.pointsPerBlock; i++) {
+		putUint16(frame, HEADER_LENGTH + i * 4, random() % 20000);
+		putUint16(frame, HEADER_LENGTH + i * 4 + 2, 200);
+	}
+	memset(frame.data() + frameLength - 4, 0xFE, 4);
+	sequence++;
+
+	size_t length = frameLength;
+	if (isTorn) {
+		length = 1 + random() % (frameLength - 1);
+	} else {
+		intactFrames.emplace_back(frame.begin(), frame.end());
+	}
+	bytes.insert(bytes.end(), frame.begin(), frame.begin() + length);
+}
+
+void CorruptStream::addControlResponse(bool isCorrupted, const FrameCheck& frameCheck) {
+	// a motor speed answer, the sequence number keeps every response distinct
+	vector<uint8_t> response = { 0x01, 0xFE, 0x01, 0x00, 0x04, 0x02, 0x05, 0x01, 0x00 };
+	response.push_back((sequence >> 24) & 0xFF);
+	response.push_back((sequence >> 16) & 0xFF);
+	response.push_back((sequence >> 8) & 0xFF);
+	response.push_back(sequence & 0xFF);
+	response.push_back(0);
+	sequence++;
+
+	for (int crc = 0; crc < 256; crc++) {
+		response.back() = crc;
+		if (frameCheck(response.data(), response.size())) break;
+	}
+
+	if (isCorrupted) {
+		response.back() ^= 1;
+	} else {
+		intactFrames.emplace_back(response.begin(), response.end());
+	}
+	bytes.insert(bytes.end(), response.begin(), response.end());
+}
+
+void CorruptStream::addGarbage() {
+	int length = 1 + random() % 64;
+	for (int i = 0; i < length; i++) {
+		bytes.push_back(random() & 0xFF);
+	}
+}
+
+void CorruptStream::addFalseHeader() {
+	vector<uint8_t> header(HEADER_LENGTH);
+	for (auto& byte : header) byte = random() & 0xFF;
+
+	const uint8_t FRAME_HEADER[] = { 0x4D, 0x53, 0x02, 0xF4, 0xEB, 0x90 };
+	memcpy(header.data(), FRAME_HEADER, sizeof(FRAME_HEADER));
+
+	// each names a block it doesn't hold. lengths stay at 10 or more, the legacy
+	// reader never advances past a shorter one
+	const SpeedMode& mode = SPEED_MODES[random() % 5];
+	switch (random() % 3) {
+	case 0:
+		// an info type the head doesn't send, claiming anything up to 64 KB
+		header[14] = 6 + random() % 250;
+		putUint16(header, 6, 10 + random() % 65526);
+		break;
+	case 1:
+		// a zero angular resolution
+		header[14] = mode.infoType;
+		putUint16(header, 12, 0);
+		putUint16(header, 6, HEADER_LENGTH + mode.pointsPerBlock * 4 + 4);
+		break;
+	default:
+		// fewer bytes than the block's points
+		header[14] = mode.infoType;
+		putUint16(header, 12, mode.angularResolution);
+		putUint16(header, 6, 10 + random() % (HEADER_LENGTH + mode.pointsPerBlock * 4 - 10));
+		break;
+	}
+
+	bytes.insert(bytes.end(), header.begin(), header.end());
+}
+
+void CorruptStream::putUint16(vector<uint8_t>& data, int offset, uint16_t value) {
+	data[offset] = (value >> 8) & 0xFF;
+	data[offset + 1] = value & 0xFF;
+}
@@ -0,0 +1,59 @@
+//
+//  CorruptStream.hpp
+//  frameBenchmark
+
+#ifndef CorruptStream_hpp
+#define CorruptStream_hpp
+
+#include <stdio.h>
+#include <random>
+#include "ofMain.h"
+
+// a seeded SL450 TCP stream: point cloud blocks laid out as orbbecEmulator builds
+// them with a control response between every few, damaged the ways a socket or a
+// confused head can damage it. the frames that arrive whole are kept in order so a
+// reader's output can be checked against them
+class CorruptStream {
+public:
+	// probabilities per frame
+	struct Faults {
+		float garbage = 0;         // random bytes before the frame
+		float falseHeaders = 0;    // a point cloud header the head never sends before the frame
+		float controlErrors = 0;   // a control response fails its CRC
+		float partials = 0;        // a block is cut short and runs into the next frame
+	};
+
+	typedef std::function<bool(const uint8_t* data, size_t length)> FrameCheck;
+
+	// the control response CRC is found with frameCheck, so the table isn't copied here
+	void generate(int numberFrames, const Faults& faults, int seed, const FrameCheck& frameCheck);
+
+	vector<uint8_t> bytes;
+	vector<size_t> readSizes;       // the stream cut up as reads off the socket
+	vector<string> intactFrames;
+
+	static constexpr size_t MAX_READ_SIZE = 1448;
+
+private:
+	void addPointCloud(int block, bool isTorn);
+	void addControlResponse(bool isCorrupted, const FrameCheck& frameCheck);
+	void addGarbage();
+	void addFalseHeader();
+
+	void putUint16(vector<uint8_t>& data, int offset, uint16_t value);
+
+	std::mt19937 random;
+	uint32_t sequence;
+
+	struct SpeedMode {
+		uint8_t infoType;
+		int pointsPerBlock;
+		int angularResolution;   // 0.001 degrees
+	};
+	static const SpeedMode SPEED_MODES[5];
+
+	static constexpr int BLOCKS_PER_SCAN = 18;
+	static constexpr int HEADER_LENGTH = 40;
+};
+
+#endif /* CorruptStream_hpp */
@@ -0,0 +1,49 @@
+//
+//  LegacyFrameReader.cpp
+//  frameBenchmark
+
+#include "LegacyFrameReader.hpp"
+
+LegacyFrameReader::LegacyFrameReader() {
+	accumBuffer.reserve(4096);
+	discardedBytes = 0;
+}
+
+void LegacyFrameReader::clear() {
+	accumBuffer.clear();
+	discardedBytes = 0;
+}
+
+void LegacyFrameReader::receive(const uint8_t* data, size_t length, const FrameHandler& onFrame) {
+	accumBuffer.insert(accumBuffer.end(), data, data + length);
+
+	// process all complete frames from accumulation buffer
+	while (accumBuffer.size() >= 10) {
+		if (accumBuffer[0] == 0x01 && accumBuffer[1] == 0xFE) {
+			// control response: header(2) + version(1) + dataLen(2) + controlCode(2) + responseCode(2) + data + crc(1)
+			uint16_t dataLength = (accumBuffer[3] << 8) | accumBuffer[4];
+			size_t frameSize = 10 + dataLength;
+
+			if (accumBuffer.size() < frameSize) break; // wait for more bytes
+
+			onFrame(accumBuffer.data(), frameSize);
+			accumBuffer.erase(accumBuffer.begin(), accumBuffer.begin() + frameSize);
+		}
+		else if (accumBuffer.size() >= 8 &&
+			accumBuffer[0] == 0x4D && accumBuffer[1] == 0x53 && accumBuffer[2] == 0x02 &&
+			accumBuffer[3] == 0xF4 && accumBuffer[4] == 0xEB && accumBuffer[5] == 0x90) {
+			// point cloud: frameLength is in bytes 6-7
+			uint16_t frameLength = (accumBuffer[6] << 8) | accumBuffer[7];
+
+			if (accumBuffer.size() < frameLength) break; // wait for more bytes
+
+			onFrame(accumBuffer.data(), frameLength);
+			accumBuffer.erase(accumBuffer.begin(), accumBuffer.begin() + frameLength);
+		}
+		else {
+			// unrecognized byte at front, discard and resync
+			accumBuffer.erase(accumBuffer.begin());
+			discardedBytes++;
+		}
+	}
+}
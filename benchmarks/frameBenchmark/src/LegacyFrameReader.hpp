@@ -0,0 +1,29 @@
+//
+//  LegacyFrameReader.hpp
+//  frameBenchmark
+
+#ifndef LegacyFrameReader_hpp
+#define LegacyFrameReader_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+
+// OrbbecPulsar's stream reassembly as it was before FrameReassembler, kept only to
+// measure against: every read appended to one vector, every frame and every
+// unrecognized byte erased from its front, no CRC and no check on the header
+class LegacyFrameReader {
+public:
+	typedef std::function<void(const uint8_t* frame, size_t length)> FrameHandler;
+
+	LegacyFrameReader();
+
+	void receive(const uint8_t* data, size_t length, const FrameHandler& onFrame);
+	void clear();
+
+	uint64_t discardedBytes;
+
+private:
+	vector<uint8_t> accumBuffer;
+};
+
+#endif /* LegacyFrameReader_hpp */
@@ -0,0 +1,12 @@
+//
+//  MeatbagsSources.cpp
+//  frameBenchmark
+
+// the parts of meatbags OrbbecPulsar needs, compiled here rather than adding src/Sensors
+// whole, which would pull in the Orbbec SDK and the rest of the app with it
+#include "DraggablePoint.cpp"
+#include "BackgroundModel.cpp"
+#include "SensorReactor.cpp"
+#include "FrameReassembler.cpp"
+#include "Sensor.cpp"
+#include "OrbbecPulsar.cpp"
@@ -0,0 +1,178 @@
+//
+//  main.cpp
+//  frameBenchmark
+
+#include "ofMain.h"
+#include "OrbbecPulsar.hpp"
+#include "FrameReassembler.hpp"
+#include "LegacyFrameReader.hpp"
+#include "CorruptStream.hpp"
+#include "Benchmark.hpp"
+
+// feeds seeded SL450 streams, clean and damaged, through FrameReassembler with
+// OrbbecPulsar's framing and through the reader it replaced. a frame counts as kept
+// when it is byte for byte one the stream sent whole, anything else a reader hands
+// on is bogus. the current reader has to keep every whole frame and nothing bogus
+// unless blocks were torn, a torn block has no CRC to give it away and takes the
+// start of the frame after it along
+
+struct Scenario {
+	string name;
+	CorruptStream::Faults faults;
+};
+
+struct Outcome {
+	int kept = 0;
+	int bogus = 0;
+	uint64_t discardedBytes = 0;
+};
+
+typedef std::function<void(const uint8_t* frame, size_t length)> FrameHandler;
+
+static void readCurrent(const CorruptStream& stream, FrameReassembler& reassembler, const FrameHandler& onFrame) {
+	reassembler.clear();
+
+	size_t offset = 0;
+	for (size_t readSize : stream.readSizes) {
+		// a read never spans more than the space the socket was handed
+		while (readSize > 0) {
+			size_t available;
+			uint8_t* buffer = reassembler.getWriteBuffer(available);
+			size_t length = std::min(readSize, available);
+
+			memcpy(buffer, stream.bytes.data() + offset, length);
+			reassembler.commit(length);
+			offset   += length;
+			readSize -= length;
+
+			const uint8_t* frame;
+			size_t frameLength;
+			while (reassembler.nextFrame(frame, frameLength)) {
+				onFrame(frame, frameLength);
+			}
+		}
+	}
+}
+
+static void readLegacy(const CorruptStream& stream, LegacyFrameReader& reader, const FrameHandler& onFrame) {
+	reader.clear();
+
+	size_t offset = 0;
+	for (size_t readSize : stream.readSizes) {
+		reader.receive(stream.bytes.data() + offset, readSize, onFrame);
+		offset += readSize;
+	}
+}
+
+// frames come out in stream order and every whole one is distinct, so one pass matches them
+static Outcome compareFrames(const vector<string>& frames, const vector<string>& intactFrames) {
+	Outcome outcome;
+	size_t next = 0;
+
+	for (const auto& frame : frames) {
+		auto found = std::find(intactFrames.begin() + next, intactFrames.end(), frame);
+		if (found == intactFrames.end()) {
+			outcome.bogus++;
+		} else {
+			outcome.kept++;
+			next = found - intactFrames.begin() + 1;
+		}
+	}
+
+	return outcome;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && string(argv[1]) == "--help") {
+		std::cout
+			<< "usage: frameBenchmark [options]\n"
+			<< "  --frames N          frames per stream, blocks and control responses (2000)\n"
+			<< "  --seed N            seed for the streams and the reads they are cut into (1)\n"
+			<< "  --iterations N      streams read per timing round (5)\n";
+		return 0;
+	}
+
+	int numberFrames = ofToInt(Benchmark::getOption(argc, argv, "--frames", "2000"));
+	int seed = ofToInt(Benchmark::getOption(argc, argv, "--seed", "1"));
+	int iterations = ofToInt(Benchmark::getOption(argc, argv, "--iterations", "5"));
+
+	OrbbecPulsar pulsar;
+	auto frameSize  = [&](const uint8_t* data, size_t length) { return pulsar.measureFrame(data, length); };
+	auto frameCheck = [&](const uint8_t* data, size_t length) { return pulsar.checkFrame(data, length); };
+
+	// the same start bytes and capacity OrbbecPulsar reads with
+	FrameReassembler reassembler;
+	reassembler.setup({ 0x4D, 0x01 }, frameSize, frameCheck);
+	LegacyFrameReader legacy;
+
+	vector<Scenario> scenarios(6);
+	scenarios[0].name = "clean";
+	scenarios[1].name = "garbage";
+	scenarios[1].faults.garbage = 0.2f;
+	scenarios[2].name = "false headers";
+	scenarios[2].faults.falseHeaders = 0.1f;
+	scenarios[3].name = "control errors";
+	scenarios[3].faults.controlErrors = 0.3f;
+	scenarios[4].name = "torn blocks";
+	scenarios[4].faults.partials = 0.05f;
+	scenarios[5].name = "everything";
+	scenarios[5].faults = { 0.2f, 0.1f, 0.3f, 0.05f };
+
+	Benchmark::printRow({ "stream", "bytes", "whole frames", "legacy kept", "current kept", "legacy bogus", "current bogus",
+		"legacy skip", "current skip", "legacy ns", "current ns", "speedup" });
+
+	bool haveAllPassed = true;
+	CorruptStream stream;
+	for (const auto& scenario : scenarios) {
+		stream.generate(numberFrames, scenario.faults, seed, frameCheck);
+
+		vector<string> legacyFrames, currentFrames;
+		readLegacy(stream, legacy, [&](const uint8_t* frame, size_t length) {
+			legacyFrames.emplace_back(frame, frame + length);
+		});
+		readCurrent(stream, reassembler, [&](const uint8_t* frame, size_t length) {
+			currentFrames.emplace_back(frame, frame + length);
+		});
+
+		Outcome legacyOutcome = compareFrames(legacyFrames, stream.intactFrames);
+		legacyOutcome.discardedBytes = legacy.discardedBytes;
+		Outcome currentOutcome = compareFrames(currentFrames, stream.intactFrames);
+		currentOutcome.discardedBytes = reassembler.getDiscardedBytes();
+
+		int numberIntact = stream.intactFrames.size();
+		if (scenario.faults.partials == 0 && (currentOutcome.kept != numberIntact || currentOutcome.bogus != 0)) {
+			ofLogError("frameBenchmark") << scenario.name << ": kept " << currentOutcome.kept << " of "
+				<< numberIntact << " whole frames with " << currentOutcome.bogus << " bogus";
+			haveAllPassed = false;
+		}
+
+		// timed per frame, handing each one on as OrbbecPulsar does without parsing it
+		size_t checksum = 0;
+		auto consume = [&](const uint8_t* frame, size_t length) { checksum += frame[length - 1]; };
+
+		Benchmark::Result legacyResult = Benchmark::measure(iterations, [&]() {
+			readLegacy(stream, legacy, consume);
+		});
+		Benchmark::Result currentResult = Benchmark::measure(iterations, [&]() {
+			readCurrent(stream, reassembler, consume);
+		});
+
+		int numberSent = std::max(numberFrames, 1);
+		Benchmark::printRow({
+			scenario.name,
+			ofToString(stream.bytes.size()),
+			ofToString(numberIntact),
+			ofToString(legacyOutcome.kept),
+			ofToString(currentOutcome.kept),
+			ofToString(legacyOutcome.bogus),
+			ofToString(currentOutcome.bogus),
+			ofToString(legacyOutcome.discardedBytes),
+			ofToString(currentOutcome.discardedBytes),
+			ofToString(legacyResult.nanoseconds / numberSent, 0),
+			ofToString(currentResult.nanoseconds / numberSent, 0),
+			ofToString(legacyResult.nanoseconds / currentResult.nanoseconds, 1) + "x"
+		});
+	}
+
+	return haveAllPassed ? 0 : 1;
+}
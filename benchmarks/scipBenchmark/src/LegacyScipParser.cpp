@@ -0,0 +1,113 @@
+//
+//  LegacyScipParser.cpp
+//  scipBenchmark
+
+#include "LegacyScipParser.hpp"
+
+LegacyScipParser::LegacyScipParser(int angularResolution) {
+	distances.assign(angularResolution, 0.0);
+	newDistancesAvailable = false;
+}
+
+void LegacyScipParser::parseResponse(const string& str) {
+	vector<string> lines = splitStringByNewline(str);
+	if (lines.size() == 0 || lines.empty()) return;
+	
+	string& header = lines[0];
+	string command = header.substr(0, 2);
+	
+	if (command == "MD") parseStreamingDistances(lines);
+}
+
+void LegacyScipParser::parseStreamingDistances(vector<string> packet) {
+	if (packet.size() < 3) return;
+	
+	const string& header = packet[0];
+	int startStep = stoi(header.substr(2, 4));
+	int endStep = stoi(header.substr(6, 4));
+	int clusterCount = stoi(header.substr(10, 2));
+	
+	// validate status and timestamp
+	if (checkSum(packet[1], 1).empty()) return;
+	if (checkSum(packet[2], 1).empty()) return;
+	
+	const int expectedDataPoints = (endStep - startStep + 1);
+	const int expectedChars = expectedDataPoints * 3;
+	
+	string concatenatedData;
+	concatenatedData.reserve(expectedChars);
+	
+	for (int i = 3; i < packet.size(); i++) {
+		string decoded = checkSum(packet[i], 1);
+		if (decoded.empty()) continue;
+		concatenatedData += decoded;
+	}
+	
+	if (concatenatedData.length() < expectedChars) return;
+	const char* raw = concatenatedData.c_str();
+	size_t numSteps = endStep - startStep + 1;
+	
+	int step = startStep;
+	for (int i = 0; i < numSteps; i++) {
+		int distance = sixBitCharDecode(raw + (i * 3), 3);
+		{
+			std::lock_guard<std::mutex> lock(distancesMutex);
+			distances[step] = distance;
+		}
+		step += 1;
+	}
+	
+	std::lock_guard<std::mutex> lock(distancesAvailableMutex);
+	newDistancesAvailable = true;
+}
+
+string LegacyScipParser::checkSum(string str, int fromEnd) {
+	if (str.size() <= static_cast<size_t>(fromEnd)) return "";
+	
+	size_t payloadLen = str.size() - fromEnd;
+	int sum = 0;
+	
+	for (size_t i = 0; i < payloadLen; ++i) {
+		sum += static_cast<unsigned char>(str[i]);
+	}
+	
+	int expected = ((sum & 0x3F) + 0x30);
+	int received = static_cast<unsigned char>(str.back());
+	
+	if (expected == received) {
+		return str.substr(0, payloadLen);
+	} else {
+		return "";
+	}
+}
+
+int LegacyScipParser::sixBitCharDecode(const char* data, int length) {
+	if (length == 2) {
+		return ((data[0] - 0x30) << 6) |
+		((data[1] - 0x30));
+	} else if (length == 3) {
+		return ((data[0] - 0x30) << 12) |
+		((data[1] - 0x30) << 6)  |
+		((data[2] - 0x30));
+	} else {
+		return 0;
+	}
+}
+
+vector<string> LegacyScipParser::splitStringByNewline(const string& str) {
+	std::vector<std::string> result;
+	size_t start = 0;
+	
+	while (start < str.length()) {
+		size_t end = str.find('\n', start);
+		if (end == std::string::npos) {
+			result.emplace_back(str.substr(start));
+			break;
+		} else {
+			result.emplace_back(str.substr(start, end - start));
+			start = end + 1;
+		}
+	}
+	
+	return result;
+}
@@ -0,0 +1,33 @@
+//
+//  LegacyScipParser.hpp
+//  scipBenchmark
+
+#ifndef LegacyScipParser_hpp
+#define LegacyScipParser_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+
+// Hokuyo's MD parser as it was before it decoded in place, kept only to measure
+// against: a string per line, substr and checksum copies per line, the payload
+// concatenated into one more string, and a lock per step
+class LegacyScipParser {
+public:
+	LegacyScipParser(int angularResolution);
+
+	void parseResponse(const string& str);
+
+	vector<float> distances;
+	bool newDistancesAvailable;
+
+private:
+	void parseStreamingDistances(vector<string> packet);
+	string checkSum(string str, int fromEnd);
+	int sixBitCharDecode(const char* data, int length);
+	vector<string> splitStringByNewline(const string& str);
+
+	std::mutex distancesMutex;
+	std::mutex distancesAvailableMutex;
+};
+
+#endif /* LegacyScipParser_hpp */
@@ -0,0 +1,11 @@
+//
+//  MeatbagsSources.cpp
+//  scipBenchmark
+
+// the parts of meatbags Hokuyo needs, compiled here rather than adding src/Sensors
+// whole, which would pull in the Orbbec SDK and the rest of the app with it
+#include "DraggablePoint.cpp"
+#include "BackgroundModel.cpp"
+#include "SensorReactor.cpp"
+#include "Sensor.cpp"
+#include "Hokuyo.cpp"
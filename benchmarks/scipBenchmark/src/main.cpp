@@ -0,0 +1,111 @@
+//
+//  main.cpp
+//  scipBenchmark
+
+#include "ofMain.h"
+#include "Hokuyo.hpp"
+#include "LegacyScipParser.hpp"
+#include "Benchmark.hpp"
+
+// decodes captured MD frames with Hokuyo's parser and with the one it replaced, checks
+// they agree, then times both. a fixture is one frame exactly as it came off the
+// socket, ending in the blank line that delimits it
+
+static const string DELIMITER = "\n\n";
+
+struct Fixture {
+	string name;
+	string frame;   // without the delimiter, as ofxTCPClient hands it over
+};
+
+static vector<Fixture> loadFixtures(const string& folder) {
+	vector<Fixture> fixtures;
+	if (!std::filesystem::is_directory(folder)) return fixtures;
+
+	for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+		if (entry.path().extension() != ".scip") continue;
+
+		std::ifstream file(entry.path(), std::ios::binary);
+		string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (bytes.size() >= DELIMITER.size() && bytes.compare(bytes.size() - DELIMITER.size(), DELIMITER.size(), DELIMITER) == 0) {
+			bytes.resize(bytes.size() - DELIMITER.size());
+		}
+
+		fixtures.push_back({ entry.path().filename().string(), bytes });
+	}
+
+	std::sort(fixtures.begin(), fixtures.end(), [](const Fixture& a, const Fixture& b) { return a.name < b.name; });
+	return fixtures;
+}
+
+// both parsers on fresh buffers, true when they decode the same ranges or both reject the frame
+static bool compareParsers(const Fixture& fixture, bool& wasDecoded) {
+	LegacyScipParser legacy(1440);
+	legacy.parseResponse(fixture.frame);
+
+	Hokuyo hokuyo;
+	hokuyo.parseResponse(fixture.frame.data(), fixture.frame.size());
+	bool wasPublished = hokuyo.updateDistances();
+
+	wasDecoded = wasPublished;
+	if (wasPublished != legacy.newDistancesAvailable) return false;
+	if (!wasPublished) return true;
+
+	return hokuyo.getDistances() == legacy.distances;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && string(argv[1]) == "--help") {
+		std::cout
+			<< "usage: scipBenchmark [options]\n"
+			<< "  --fixtures PATH     folder of .scip frames (data/)\n"
+			<< "  --iterations N      frames parsed per timing round (2000)\n";
+		return 0;
+	}
+
+	string folder = Benchmark::getOption(argc, argv, "--fixtures", ofToDataPath("", true));
+	int iterations = ofToInt(Benchmark::getOption(argc, argv, "--iterations", "2000"));
+
+	vector<Fixture> fixtures = loadFixtures(folder);
+	if (fixtures.empty()) {
+		ofLogError("scipBenchmark") << "No .scip fixtures in " << folder;
+		return 1;
+	}
+
+	Benchmark::printRow({ "fixture", "bytes", "result", "legacy ns", "current ns", "speedup", "legacy allocs", "current allocs" });
+
+	bool haveAllMatched = true;
+	for (const auto& fixture : fixtures) {
+		bool wasDecoded;
+		bool isMatch = compareParsers(fixture, wasDecoded);
+		if (!isMatch) {
+			ofLogError("scipBenchmark") << fixture.name << " decodes differently with the two parsers";
+			haveAllMatched = false;
+			continue;
+		}
+
+		// the legacy parser was handed a string by ofxTCPClient::receive, built outside the timing here
+		LegacyScipParser legacy(1440);
+		Benchmark::Result legacyResult = Benchmark::measure(iterations, [&]() {
+			legacy.parseResponse(fixture.frame);
+		});
+
+		Hokuyo hokuyo;
+		Benchmark::Result currentResult = Benchmark::measure(iterations, [&]() {
+			hokuyo.parseResponse(fixture.frame.data(), fixture.frame.size());
+		});
+
+		Benchmark::printRow({
+			fixture.name,
+			ofToString(fixture.frame.size() + DELIMITER.size()),
+			wasDecoded ? "decoded" : "rejected",
+			ofToString(legacyResult.nanoseconds, 0),
+			ofToString(currentResult.nanoseconds, 0),
+			ofToString(legacyResult.nanoseconds / currentResult.nanoseconds, 1) + "x",
+			ofToString(legacyResult.allocations, 1),
+			ofToString(currentResult.allocations, 1)
+		});
+	}
+
+	return haveAllMatched ? 0 : 1;
+}
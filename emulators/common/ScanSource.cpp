@@ -0,0 +1,113 @@
+//
+//  ScanSource.cpp
+//  emulators
+
+#include "ScanSource.hpp"
+
+SyntheticSource::SyntheticSource(int seed, int numberPeople) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (int i = 0; i < numberPeople; i++) {
+		Person person;
+		person.orbitRadius = 1000.0f + unit(random) * 4000.0f;
+		// walking pace, 0.5 to 1.5 m/s, in either direction
+		person.orbitSpeed = (500.0f + unit(random) * 1000.0f) / person.orbitRadius * (unit(random) < 0.5f ? -1.0f : 1.0f);
+		person.orbitPhase = unit(random) * TWO_PI;
+		people.push_back(person);
+	}
+}
+
+void SyntheticSource::fill(vector<float>& distances, float startAngle, float stepAngle, uint64_t timeUs) {
+	std::fill(distances.begin(), distances.end(), ROOM_RADIUS);
+
+	float seconds = timeUs / 1000000.0f;
+	float radiusSquared = PERSON_RADIUS * PERSON_RADIUS;
+
+	for (const auto& person : people) {
+		float angle = person.orbitPhase + person.orbitSpeed * seconds;
+		float x = cos(angle) * person.orbitRadius;
+		float y = sin(angle) * person.orbitRadius;
+		float distanceSquared = x * x + y * y;
+
+		for (int i = 0; i < distances.size(); i++) {
+			float theta = startAngle + i * stepAngle;
+			float along = x * cos(theta) + y * sin(theta);
+			float discriminant = along * along - (distanceSquared - radiusSquared);
+			if (along <= 0 || discriminant < 0) continue;
+
+			distances[i] = std::min(distances[i], along - sqrt(discriminant));
+		}
+	}
+}
+
+bool RecordingSource::load(const string& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		ofLogError("RecordingSource") << "Could not open " << path;
+		return false;
+	}
+
+	vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	ScanFile::FileHeader header;
+	ScanFile::FileFooter footer = {};
+	if (data.size() < sizeof(header)) return false;
+
+	memcpy(&header, data.data(), sizeof(header));
+	if (data.size() >= sizeof(header) + sizeof(footer)) {
+		memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+	}
+
+	if (memcmp(header.magic, ScanFile::MAGIC, sizeof(header.magic)) != 0 || header.version != ScanFile::VERSION) {
+		ofLogError("RecordingSource") << path << " is not a scan recording";
+		return false;
+	}
+
+	// a recording that never stopped cleanly has no index, its records are walked instead
+	const uint8_t* bytes = (const uint8_t*)data.data();
+	vector<ScanFile::IndexEntry> index;
+	size_t scansEnd;
+
+	if (memcmp(footer.magic, ScanFile::MAGIC, sizeof(footer.magic)) == 0 &&
+		footer.indexOffset + footer.numberScans * sizeof(ScanFile::IndexEntry) + sizeof(footer) == data.size()) {
+		index.resize(footer.numberScans);
+		memcpy(index.data(), bytes + footer.indexOffset, index.size() * sizeof(ScanFile::IndexEntry));
+		scansEnd = footer.indexOffset;
+	} else {
+		scansEnd = ScanFile::rebuildIndex(bytes, data.size(), index);
+		ofLogWarning("RecordingSource") << path << " has no index, recovered " << index.size() << " scans from its records";
+	}
+
+	samples.clear();
+	scanOffsets.clear();
+	scanLengths.clear();
+
+	for (const auto& entry : index) {
+		ScanFile::ScanHeader scan;
+		if (entry.offset + sizeof(scan) > scansEnd) break;
+		memcpy(&scan, bytes + entry.offset, sizeof(scan));
+
+		size_t numberSteps = std::max(scan.numberSteps, 0);
+		if (entry.offset + sizeof(scan) + numberSteps * sizeof(float) > scansEnd) break;
+
+		scanOffsets.push_back(samples.size());
+		scanLengths.push_back(numberSteps);
+		samples.resize(samples.size() + numberSteps);
+		memcpy(samples.data() + scanOffsets.back(), bytes + entry.offset + sizeof(scan), numberSteps * sizeof(float));
+	}
+
+	ofLogNotice("RecordingSource") << "Loaded " << scanOffsets.size() << " scans from " << path;
+	return !scanOffsets.empty();
+}
+
+void RecordingSource::fill(vector<float>& distances, float startAngle, float stepAngle, uint64_t timeUs) {
+	std::fill(distances.begin(), distances.end(), 0.0f);
+	if (scanOffsets.empty()) return;
+
+	// recordings are replayed step for step, the angles are the recorded sensor's own
+	size_t numberSteps = std::min(scanLengths[nextScan], distances.size());
+	std::copy_n(samples.begin() + scanOffsets[nextScan], numberSteps, distances.begin());
+
+	nextScan = (nextScan + 1) % scanOffsets.size();
+}
@@ -0,0 +1,53 @@
+//
+//  ScanSource.hpp
+//  emulators
+
+#ifndef ScanSource_hpp
+#define ScanSource_hpp
+
+#include <stdio.h>
+#include <random>
+#include "ofMain.h"
+#include "ScanFile.h"
+
+// where an emulated sensor's scans come from. distances are in mm per step, 0 for
+// no return, with step 0 at startAngle and steps advancing counter clockwise
+class ScanSource {
+public:
+	virtual ~ScanSource() {}
+
+	virtual void fill(vector<float>& distances, float startAngle, float stepAngle, uint64_t timeUs) = 0;
+};
+
+// a round room with people walking circles around the sensor
+class SyntheticSource : public ScanSource {
+public:
+	SyntheticSource(int seed, int numberPeople);
+
+	void fill(vector<float>& distances, float startAngle, float stepAngle, uint64_t timeUs) override;
+
+private:
+	struct Person {
+		float orbitRadius, orbitSpeed, orbitPhase;
+	};
+
+	vector<Person> people;
+
+	static constexpr float ROOM_RADIUS = 6000.0;
+	static constexpr float PERSON_RADIUS = 200.0;
+};
+
+// replays a meatbags scan recording in order, looping, regardless of its timing
+class RecordingSource : public ScanSource {
+public:
+	bool load(const string& path);
+
+	void fill(vector<float>& distances, float startAngle, float stepAngle, uint64_t timeUs) override;
+
+private:
+	vector<float> samples;
+	vector<size_t> scanOffsets, scanLengths;
+	size_t nextScan = 0;
+};
+
+#endif /* ScanSource_hpp */
@@ -0,0 +1,379 @@
+//
+//  HokuyoEmulator.cpp
+//  hokuyoEmulator
+
+#include "HokuyoEmulator.hpp"
+
+HokuyoEmulator::HokuyoEmulator() {
+	scanRate = 40;
+	scan.assign(MAX_STEP + 1, 0.0f);
+}
+
+HokuyoEmulator::~HokuyoEmulator() {
+	stop();
+}
+
+bool HokuyoEmulator::setup(const string& _address, int port, std::unique_ptr<ScanSource> _source, int seed) {
+	address = _address;
+	source = std::move(_source);
+	random.seed(seed);
+
+	ofxTCPSettings settings(address, port);
+	settings.reuse = true;
+	if (!server.setup(settings)) return false;
+
+	startTime = std::chrono::steady_clock::now();
+	startThread();
+
+	ofLogNotice("HokuyoEmulator") << "Listening on " << address << ":" << port;
+	return true;
+}
+
+void HokuyoEmulator::stop() {
+	if (isThreadRunning()) {
+		stopThread();
+		waitForThread(false);
+	}
+
+	if (server.isConnected()) server.close();
+}
+
+HokuyoEmulator::Stats HokuyoEmulator::takeStats() {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	Stats taken = stats;
+	stats = Stats();
+	stats.clients = taken.clients;
+	return taken;
+}
+
+void HokuyoEmulator::threadedFunction() {
+	auto scanInterval = std::chrono::microseconds((int64_t)(1000000.0f / std::max(scanRate, 1.0f)));
+	auto nextScan = std::chrono::steady_clock::now() + scanInterval;
+
+	while (isThreadRunning()) {
+		for (int clientId = 0; clientId < server.getLastID(); clientId++) {
+			if (!server.isClientConnected(clientId)) {
+				clients.erase(clientId);
+				continue;
+			}
+
+			receiveCommands(clientId, clients[clientId]);
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (now >= nextScan) {
+			// like the real head, a late scan is skipped rather than sent twice
+			nextScan += scanInterval;
+			if (nextScan < now) nextScan = now + scanInterval;
+
+			float stepAngle = TWO_PI / STEPS_PER_TURN;
+			uint64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(now - startTime).count();
+			source->fill(scan, -FRONT_STEP * stepAngle, stepAngle, timeUs);
+
+			vector<int> streamingIds;
+			for (auto& [clientId, client] : clients) {
+				if (client.isStreaming) streamingIds.push_back(clientId);
+			}
+			for (int clientId : streamingIds) {
+				streamScan(clientId, clients[clientId]);
+			}
+
+			std::lock_guard<std::mutex> lock(statsMutex);
+			stats.clients = clients.size();
+		}
+
+		std::this_thread::sleep_until(std::min(nextScan, now + std::chrono::milliseconds(1)));
+	}
+}
+
+void HokuyoEmulator::receiveCommands(int clientId, Client& client) {
+	char buffer[1024];
+	int received;
+	while ((received = server.receiveRawBytes(clientId, buffer, sizeof(buffer))) > 0) {
+		client.input.append(buffer, received);
+	}
+
+	// commands end with LF, meatbags sends an extra one that reads as an empty command
+	size_t lineEnd;
+	while ((lineEnd = client.input.find('\n')) != string::npos) {
+		string command = client.input.substr(0, lineEnd);
+		client.input.erase(0, lineEnd + 1);
+
+		if (!command.empty() && command.back() == '\r') command.pop_back();
+		if (command.empty()) continue;
+
+		handleCommand(clientId, client, command);
+
+		// rebooted
+		if (clients.find(clientId) == clients.end()) return;
+	}
+}
+
+void HokuyoEmulator::handleCommand(int clientId, Client& client, const string& command) {
+	string name = command.substr(0, 2);
+	if (name == "MD" || name == "MS" || name == "GD" || name == "GS") {
+		handleScanCommand(clientId, client, command);
+		return;
+	}
+
+	string response = command + "\n";
+	bool isRebooting = false;
+
+	if (name == "BM") {
+		appendStatus(response, client.isLaserOn ? "02" : "00");
+		client.isLaserOn = true;
+	} else if (name == "QT") {
+		client.isStreaming = false;
+		client.isLaserOn = false;
+		appendStatus(response, "00");
+	} else if (name == "RS") {
+		client.isStreaming = false;
+		appendStatus(response, "00");
+	} else if (name == "CR") {
+		appendStatus(response, "00");
+	} else if (name == "RB") {
+		// the first RB arms the reboot, the second one performs it
+		client.rebootRequests++;
+		isRebooting = client.rebootRequests >= 2;
+		appendStatus(response, isRebooting ? "00" : "01");
+	} else if (name == "II") {
+		appendStatus(response, "00");
+		appendInfo(response, "MODL", "UST-10LX");
+		appendInfo(response, "LASR", client.isLaserOn ? "ON" : "OFF");
+		appendInfo(response, "SCSP", "Initial(2400[rpm])");
+		appendInfo(response, "MESM", client.isStreaming ? "Measuring by Sensitive Mode" : "Idle");
+		appendInfo(response, "SBPS", "Ethernet 100 [Mbps]");
+		appendInfo(response, "TIME", "0000");
+		appendInfo(response, "STAT", "Sensor works well.");
+	} else if (name == "VV") {
+		appendStatus(response, "00");
+		appendInfo(response, "VEND", "Hokuyo Automatic Co., Ltd.");
+		appendInfo(response, "PROD", "SOKUIKI Sensor UST-10LX (emulated)");
+		appendInfo(response, "FIRM", "4.0.0");
+		appendInfo(response, "PROT", "SCIP 2.0");
+		appendInfo(response, "SERI", address);
+	} else if (name == "PP") {
+		appendStatus(response, "00");
+		appendInfo(response, "MODL", "UST-10LX");
+		appendInfo(response, "DMIN", ofToString(MIN_DISTANCE));
+		appendInfo(response, "DMAX", ofToString(MAX_DISTANCE));
+		appendInfo(response, "ARES", ofToString(STEPS_PER_TURN));
+		appendInfo(response, "AMIN", ofToString(MIN_STEP));
+		appendInfo(response, "AMAX", ofToString(MAX_STEP));
+		appendInfo(response, "AFRT", ofToString(FRONT_STEP));
+		appendInfo(response, "SCAN", ofToString((int)(scanRate * 60)));
+	} else {
+		// command not defined
+		appendStatus(response, "0E");
+	}
+
+	response += "\n";
+	sendFrame(clientId, response, false);
+
+	if (isRebooting) {
+		server.disconnectClient(clientId);
+		clients.erase(clientId);
+	}
+}
+
+void HokuyoEmulator::handleScanCommand(int clientId, Client& client, const string& command) {
+	bool isStreaming = command[0] == 'M';
+	string response = command + "\n";
+
+	int startStep    = decodeDecimal(command, 2, 4);
+	int endStep      = decodeDecimal(command, 6, 4);
+	int clusterCount = decodeDecimal(command, 10, 2);
+	int skipScans    = isStreaming ? decodeDecimal(command, 12, 1) : 0;
+	int numberScans  = isStreaming ? decodeDecimal(command, 13, 2) : 0;
+
+	if (startStep < MIN_STEP || endStep > MAX_STEP || endStep < startStep ||
+		clusterCount < 0 || skipScans < 0 || numberScans < 0) {
+		// parameter error
+		appendStatus(response, "0A");
+		response += "\n";
+		sendFrame(clientId, response, false);
+		return;
+	}
+
+	client.startStep         = startStep;
+	client.endStep           = endStep;
+	client.clusterCount      = std::max(clusterCount, 1);
+	client.isTwoCharEncoding = command[1] == 'S';
+
+	if (isStreaming) {
+		client.echo           = command.substr(0, 15);
+		client.skipScans      = skipScans;
+		client.skippedScans   = 0;
+		client.remainingScans = numberScans;
+		client.isStreaming    = true;
+		client.isLaserOn      = true;
+
+		appendStatus(response, "00");
+		response += "\n";
+		sendFrame(clientId, response, false);
+		return;
+	}
+
+	if (!client.isLaserOn) {
+		appendStatus(response, "10");
+		response += "\n";
+		sendFrame(clientId, response, false);
+		return;
+	}
+
+	appendStatus(response, "00");
+	appendTimestamp(response);
+	appendScan(response, client);
+	response += "\n";
+	sendFrame(clientId, response, true);
+}
+
+void HokuyoEmulator::streamScan(int clientId, Client& client) {
+	if (client.skippedScans < client.skipScans) {
+		client.skippedScans++;
+		return;
+	}
+	client.skippedScans = 0;
+
+	// a counted stream echoes how many scans are left and stops at zero
+	frame = client.echo;
+	if (client.remainingScans > 0) {
+		client.remainingScans--;
+		frame.replace(13, 2, ofToString(client.remainingScans, 2, '0'));
+		if (client.remainingScans == 0) client.isStreaming = false;
+	}
+
+	frame += "\n";
+	appendStatus(frame, "99");
+	appendTimestamp(frame);
+	appendScan(frame, client);
+	frame += "\n";
+	sendFrame(clientId, frame, true);
+
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	if (unit(random) < faults.disconnectsPerMinute / (60.0f * scanRate)) {
+		server.disconnectClient(clientId);
+		clients.erase(clientId);
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.disconnects++;
+	}
+}
+
+void HokuyoEmulator::sendFrame(int clientId, string& data, bool isScan) {
+	size_t length = data.size();
+
+	if (isScan) {
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::lock_guard<std::mutex> lock(statsMutex);
+
+		if (unit(random) < faults.drops) {
+			stats.dropped++;
+			return;
+		}
+
+		if (unit(random) < faults.checksumErrors) {
+			// flip the checksum of one data line, they start after echo, status and timestamp
+			vector<size_t> lineEnds;
+			for (size_t i = 0; i + 1 < data.size(); i++) {
+				if (data[i] == '\n') lineEnds.push_back(i);
+			}
+			if (lineEnds.size() > 3) {
+				size_t line = 3 + random() % (lineEnds.size() - 3);
+				data[lineEnds[line] - 1] ^= 1;
+				stats.corrupted++;
+			}
+		}
+
+		// a torn frame runs into the next one, the client has to resynchronize
+		if (unit(random) < faults.partials && length > 2) {
+			length = 1 + random() % (length - 2);
+			stats.torn++;
+		}
+
+		stats.frames++;
+		stats.bytes += length;
+	}
+
+	server.sendRawBytes(clientId, data.data(), (int)length);
+}
+
+void HokuyoEmulator::appendStatus(string& out, const string& status) {
+	out += status;
+	out += checkSum(status.data(), status.size());
+	out += '\n';
+}
+
+void HokuyoEmulator::appendInfo(string& out, const string& name, const string& value) {
+	string line = name + ":" + value;
+	out += line;
+	out += ';';
+	out += checkSum(line.data(), line.size());
+	out += '\n';
+}
+
+void HokuyoEmulator::appendTimestamp(string& out) {
+	auto elapsed = std::chrono::steady_clock::now() - startTime;
+	int timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() & 0xFFFFFF;
+
+	size_t lineStart = out.size();
+	for (int shift = 18; shift >= 0; shift -= 6) {
+		out += (char)(((timestamp >> shift) & 0x3F) + 0x30);
+	}
+	out += checkSum(out.data() + lineStart, 4);
+	out += '\n';
+}
+
+void HokuyoEmulator::appendScan(string& out, const Client& client) {
+	int numberChars = client.isTwoCharEncoding ? 2 : 3;
+	int maxValue = (1 << (6 * numberChars)) - 1;
+
+	size_t lineStart = out.size();
+	int lineLength = 0;
+
+	for (int step = client.startStep; step <= client.endStep; step += client.clusterCount) {
+		// a cluster reports the nearest return of its steps
+		float distance = 0;
+		int clusterEnd = std::min(step + client.clusterCount - 1, client.endStep);
+		for (int i = step; i <= clusterEnd; i++) {
+			if (scan[i] >= MIN_DISTANCE && (distance == 0 || scan[i] < distance)) distance = scan[i];
+		}
+		int value = std::min((int)distance, maxValue);
+
+		// 64 data chars per line, a value may straddle two lines
+		for (int shift = (numberChars - 1) * 6; shift >= 0; shift -= 6) {
+			out += (char)(((value >> shift) & 0x3F) + 0x30);
+
+			if (++lineLength == LINE_LENGTH) {
+				out += checkSum(out.data() + lineStart, LINE_LENGTH);
+				out += '\n';
+				lineStart = out.size();
+				lineLength = 0;
+			}
+		}
+	}
+
+	if (lineLength > 0) {
+		out += checkSum(out.data() + lineStart, lineLength);
+		out += '\n';
+	}
+}
+
+char HokuyoEmulator::checkSum(const char* data, size_t length) {
+	int sum = 0;
+	for (size_t i = 0; i < length; i++) {
+		sum += static_cast<unsigned char>(data[i]);
+	}
+	return (char)((sum & 0x3F) + 0x30);
+}
+
+int HokuyoEmulator::decodeDecimal(const string& str, size_t from, size_t length) {
+	if (from + length > str.size()) return -1;
+
+	int value = 0;
+	for (size_t i = from; i < from + length; i++) {
+		if (str[i] < '0' || str[i] > '9') return -1;
+		value = value * 10 + (str[i] - '0');
+	}
+	return value;
+}
@@ -0,0 +1,97 @@
+//
+//  HokuyoEmulator.hpp
+//  hokuyoEmulator
+
+#ifndef HokuyoEmulator_hpp
+#define HokuyoEmulator_hpp
+
+#include <stdio.h>
+#include <random>
+#include "ofMain.h"
+#include "ofxNetwork.h"
+#include "ScanSource.hpp"
+
+// one emulated UST-10LX on its own address, answering the SCIP 2.0 commands
+// meatbags' Hokuyo sends and streaming MD/MS scans from a ScanSource
+class HokuyoEmulator : public ofThread {
+public:
+	// per scan probabilities, disconnects are per minute of streaming
+	struct Faults {
+		float checksumErrors = 0;
+		float drops = 0;
+		float partials = 0;
+		float disconnectsPerMinute = 0;
+	};
+
+	struct Stats {
+		int clients = 0;
+		int frames = 0;
+		size_t bytes = 0;
+		int corrupted = 0;
+		int dropped = 0;
+		int torn = 0;
+		int disconnects = 0;
+	};
+
+	HokuyoEmulator();
+	~HokuyoEmulator();
+
+	bool setup(const string& address, int port, std::unique_ptr<ScanSource> source, int seed);
+	void stop();
+
+	// counters since the previous call
+	Stats takeStats();
+
+	string address;
+	float scanRate;
+	Faults faults;
+
+private:
+	struct Client {
+		string input;
+		string echo;
+		bool isStreaming = false;
+		bool isLaserOn = false;
+		bool isTwoCharEncoding = false;
+		int startStep = 0, endStep = 0, clusterCount = 1;
+		int skipScans = 0, skippedScans = 0;
+		int remainingScans = 0;
+		int rebootRequests = 0;
+	};
+
+	void threadedFunction() override;
+	void receiveCommands(int clientId, Client& client);
+	void handleCommand(int clientId, Client& client, const string& command);
+	void handleScanCommand(int clientId, Client& client, const string& command);
+	void streamScan(int clientId, Client& client);
+	void sendFrame(int clientId, string& frame, bool isScan);
+
+	void appendStatus(string& out, const string& status);
+	void appendInfo(string& out, const string& name, const string& value);
+	void appendTimestamp(string& out);
+	void appendScan(string& out, const Client& client);
+	char checkSum(const char* data, size_t length);
+	int  decodeDecimal(const string& str, size_t from, size_t length);
+
+	ofxTCPServer server;
+	std::map<int, Client> clients;
+	std::unique_ptr<ScanSource> source;
+	vector<float> scan;
+	string frame;
+	std::mt19937 random;
+	std::chrono::steady_clock::time_point startTime;
+
+	std::mutex statsMutex;
+	Stats stats;
+
+	// UST-10LX parameters, as reported by PP
+	static constexpr int MIN_DISTANCE = 20;
+	static constexpr int MAX_DISTANCE = 30000;
+	static constexpr int STEPS_PER_TURN = 1440;
+	static constexpr int MIN_STEP = 0;
+	static constexpr int MAX_STEP = 1080;
+	static constexpr int FRONT_STEP = 540;
+	static constexpr int LINE_LENGTH = 64;
+};
+
+#endif /* HokuyoEmulator_hpp */
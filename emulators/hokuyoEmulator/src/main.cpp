@@ -0,0 +1,130 @@
+//
+//  main.cpp
+//  hokuyoEmulator
+
+#include "ofMain.h"
+#include "HokuyoEmulator.hpp"
+#include <csignal>
+
+// emulates a rig of Hokuyo UST-10LX sensors on consecutive loopback addresses,
+// 127.0.0.1, 127.0.0.2, ... all on the SCIP port, so meatbags connects to them
+// exactly as it would to real sensors
+
+static std::atomic<bool> isRunning{ true };
+
+static void printUsage() {
+	std::cout
+		<< "usage: hokuyoEmulator [options]\n"
+		<< "  --sensors N              emulated sensors, one address each (1)\n"
+		<< "  --address IP             first address, later sensors count up (127.0.0.1)\n"
+		<< "  --port PORT              SCIP port (10940)\n"
+		<< "  --rate HZ                scans per second (40)\n"
+		<< "  --people N               people walking around each synthetic sensor (8)\n"
+		<< "  --recording PATH         replay a .mbscan, or sensor_<n>.mbscan from a folder\n"
+		<< "  --checksum-errors P      probability a scan has a corrupted line (0)\n"
+		<< "  --drops P                probability a scan is not sent (0)\n"
+		<< "  --partial P              probability a scan is cut short (0)\n"
+		<< "  --disconnects N          dropped connections per sensor per minute (0)\n";
+}
+
+int main(int argc, char* argv[]) {
+	int numberSensors = 1;
+	string address = "127.0.0.1";
+	int port = 10940;
+	float scanRate = 40;
+	int numberPeople = 8;
+	string recording;
+	HokuyoEmulator::Faults faults;
+
+	for (int i = 1; i < argc; i++) {
+		string option = argv[i];
+		if (option == "--help") {
+			printUsage();
+			return 0;
+		}
+
+		if (i + 1 >= argc) {
+			printUsage();
+			return 1;
+		}
+		string value = argv[++i];
+
+		if (option == "--sensors")              numberSensors = ofToInt(value);
+		else if (option == "--address")         address = value;
+		else if (option == "--port")            port = ofToInt(value);
+		else if (option == "--rate")            scanRate = ofToFloat(value);
+		else if (option == "--people")          numberPeople = ofToInt(value);
+		else if (option == "--recording")       recording = value;
+		else if (option == "--checksum-errors") faults.checksumErrors = ofToFloat(value);
+		else if (option == "--drops")           faults.drops = ofToFloat(value);
+		else if (option == "--partial")         faults.partials = ofToFloat(value);
+		else if (option == "--disconnects")     faults.disconnectsPerMinute = ofToFloat(value);
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	vector<string> octets = ofSplitString(address, ".");
+	if (octets.size() != 4) {
+		ofLogError("hokuyoEmulator") << "Invalid address " << address;
+		return 1;
+	}
+
+	std::signal(SIGINT, [](int) { isRunning = false; });
+
+	vector<std::unique_ptr<HokuyoEmulator>> emulators;
+	for (int i = 0; i < numberSensors; i++) {
+		string sensorAddress = octets[0] + "." + octets[1] + "." + octets[2] + "." + ofToString(ofToInt(octets[3]) + i);
+
+		std::unique_ptr<ScanSource> source;
+		if (recording.empty()) {
+			source = std::make_unique<SyntheticSource>(i + 1, numberPeople);
+		} else {
+			bool isFile = ofIsStringInString(recording, ScanFile::EXTENSION);
+			string path = isFile ? recording : recording + "/sensor_" + ofToString(i + 1) + ScanFile::EXTENSION;
+
+			auto recordingSource = std::make_unique<RecordingSource>();
+			if (!recordingSource->load(path)) return 1;
+			source = std::move(recordingSource);
+		}
+
+		auto emulator = std::make_unique<HokuyoEmulator>();
+		emulator->scanRate = scanRate;
+		emulator->faults = faults;
+		if (!emulator->setup(sensorAddress, port, std::move(source), i + 1)) return 1;
+
+		emulators.push_back(std::move(emulator));
+	}
+
+	// one line a second, summed over every sensor
+	while (isRunning) {
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+
+		HokuyoEmulator::Stats total;
+		for (auto& emulator : emulators) {
+			HokuyoEmulator::Stats stats = emulator->takeStats();
+			total.clients     += stats.clients;
+			total.frames      += stats.frames;
+			total.bytes       += stats.bytes;
+			total.corrupted   += stats.corrupted;
+			total.dropped     += stats.dropped;
+			total.torn        += stats.torn;
+			total.disconnects += stats.disconnects;
+		}
+
+		std::cout << "clients " << total.clients
+				  << "  scans/s " << total.frames
+				  << "  MB/s " << ofToString(total.bytes / 1000000.0, 2)
+				  << "  corrupted " << total.corrupted
+				  << "  dropped " << total.dropped
+				  << "  torn " << total.torn
+				  << "  disconnects " << total.disconnects << std::endl;
+	}
+
+	for (auto& emulator : emulators) {
+		emulator->stop();
+	}
+
+	return 0;
+}
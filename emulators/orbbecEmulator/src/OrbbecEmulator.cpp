@@ -0,0 +1,420 @@
+//
+//  OrbbecEmulator.cpp
+//  orbbecEmulator
+
+#include "OrbbecEmulator.hpp"
+
+const OrbbecEmulator::SpeedMode OrbbecEmulator::SPEED_MODES[5] = {
+	{ 900,  1, 200, 75 },
+	{ 1200, 2, 150, 100 },
+	{ 1500, 3, 120, 125 },
+	{ 1800, 4, 100, 150 },
+	{ 2400, 5, 75,  200 },
+};
+
+OrbbecEmulator::OrbbecEmulator() {
+	udpPort = 2228;
+	isUdp = false;
+
+	motorSpeed = 1200;
+	isStandby = false;
+	isFogMode = false;
+	isStreamEnabled = false;
+
+	lidarState = 1;
+	faultCode = 0;
+	warningSeconds = 0;
+
+	revolution = 0;
+	nextBlock = 0;
+	rotationAngle = 0;
+
+	frame.reserve(HEADER_LENGTH + SPEED_MODES[0].pointsPerBlock * 4 + 4);
+	response.reserve(64);
+}
+
+OrbbecEmulator::~OrbbecEmulator() {
+	stop();
+}
+
+bool OrbbecEmulator::setup(const string& _address, int port, std::unique_ptr<ScanSource> _source, int seed) {
+	address = _address;
+	source = std::move(_source);
+	random.seed(seed);
+
+	ofxTCPSettings settings(address, port);
+	settings.reuse = true;
+	if (!server.setup(settings)) return false;
+
+	startTime = std::chrono::steady_clock::now();
+	lastUpdateTime = startTime;
+	startThread();
+
+	ofLogNotice("OrbbecEmulator") << "Listening on " << address << ":" << port;
+	return true;
+}
+
+void OrbbecEmulator::stop() {
+	if (isThreadRunning()) {
+		stopThread();
+		waitForThread(false);
+	}
+
+	if (server.isConnected()) server.close();
+}
+
+OrbbecEmulator::Stats OrbbecEmulator::takeStats() {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	Stats taken = stats;
+	stats = Stats();
+	stats.clients = taken.clients;
+	return taken;
+}
+
+const OrbbecEmulator::SpeedMode& OrbbecEmulator::speedMode() const {
+	for (const auto& mode : SPEED_MODES) {
+		if (mode.rpm == motorSpeed) return mode;
+	}
+	return SPEED_MODES[1];
+}
+
+void OrbbecEmulator::threadedFunction() {
+	while (isThreadRunning()) {
+		for (int clientId = 0; clientId < server.getLastID(); clientId++) {
+			if (!server.isClientConnected(clientId)) {
+				clients.erase(clientId);
+				continue;
+			}
+
+			receiveCommands(clientId, clients[clientId]);
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		float seconds = std::chrono::duration<float>(now - lastUpdateTime).count();
+		lastUpdateTime = now;
+
+		// a stall is not caught up on, the head just keeps turning
+		seconds = std::min(seconds, 0.1f);
+
+		updateFaults(seconds);
+		if (!isStandby) {
+			rotationAngle += seconds * motorSpeed / 60.0f * 360.0f;
+			streamBlocks(now);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(statsMutex);
+			stats.clients = clients.size();
+		}
+
+		std::this_thread::sleep_for(std::chrono::microseconds(500));
+	}
+}
+
+void OrbbecEmulator::receiveCommands(int clientId, Client& client) {
+	uint8_t buffer[1024];
+	int received;
+	while ((received = server.receiveRawBytes(clientId, (char*)buffer, sizeof(buffer))) > 0) {
+		client.input.insert(client.input.end(), buffer, buffer + received);
+	}
+
+	// header(2) + version(1) + dataLen(2) + register(2) + reserved(2) + data + crc(1)
+	size_t offset = 0;
+	while (client.input.size() - offset >= 2) {
+		const uint8_t* command = client.input.data() + offset;
+		if (command[0] != 0x01 || command[1] != 0xFE) {
+			offset++;
+			continue;
+		}
+
+		if (client.input.size() - offset < 5) break;
+		size_t length = 10 + ((command[3] << 8) | command[4]);
+		if (client.input.size() - offset < length) break;
+
+		// a corrupted command is ignored, meatbags resends on its next check
+		if (calculateCRC8(command, length - 1) == command[length - 1]) {
+			handleCommand(clientId, client, command, length);
+		}
+		offset += length;
+	}
+	client.input.erase(client.input.begin(), client.input.begin() + offset);
+}
+
+void OrbbecEmulator::handleCommand(int clientId, Client& client, const uint8_t* command, size_t length) {
+	uint16_t controlCode = (command[5] << 8) | command[6];
+	size_t dataLength = length - 10;
+
+	bool hasValue = dataLength >= 4;
+	uint32_t value = hasValue ? (command[9] << 24) | (command[10] << 16) | (command[11] << 8) | command[12] : 0;
+
+	switch (controlCode) {
+	case REG_CONNECT_DEVICE: {
+		client.isConnected = true;
+		sendResponse(clientId, controlCode, true);
+		break;
+	}
+	case REG_SET_DATA_STREAM: {
+		if (hasValue) isStreamEnabled = value == 1;
+		sendResponse(clientId, controlCode, hasValue && value <= 1);
+		break;
+	}
+	case REG_SET_MOTOR_SPEED: {
+		bool isValid = false;
+		for (const auto& mode : SPEED_MODES) {
+			if (hasValue && mode.rpm == value) isValid = true;
+		}
+		if (isValid && value != motorSpeed) {
+			// the next revolution is streamed at the new layout
+			motorSpeed = value;
+			nextBlock = BLOCKS_PER_SCAN;
+		}
+		sendResponse(clientId, controlCode, isValid);
+		break;
+	}
+	case REG_SET_WORKING_MODE: {
+		bool isValid = hasValue && value <= 1;
+		if (isValid) {
+			// coming out of standby clears a held fault, the recovery meatbags relies on
+			if (isStandby && value == 0 && lidarState == 3) {
+				lidarState = 1;
+				faultCode = 0;
+
+				std::lock_guard<std::mutex> lock(statsMutex);
+				stats.resets++;
+			}
+			isStandby = value == 1;
+		}
+		sendResponse(clientId, controlCode, isValid);
+		break;
+	}
+	case REG_SET_TCP_MODE: {
+		bool isValid = hasValue && value <= 1;
+		if (isValid) isUdp = value == 0;
+		sendResponse(clientId, controlCode, isValid);
+		break;
+	}
+	case REG_SET_SPECIAL_WORKING_MODE: {
+		bool isValid = hasValue && value <= 1;
+		if (isValid) isFogMode = value == 1;
+		sendResponse(clientId, controlCode, isValid);
+		break;
+	}
+	case GET_MOTOR_SPEED:      sendResponse(clientId, controlCode, true, uint32ToBytes(motorSpeed)); break;
+	case GET_TRANS_PROTOCOL:   sendResponse(clientId, controlCode, true, uint32ToBytes(isUdp ? 0 : 1)); break;
+	case GET_WORKING_MODE:     sendResponse(clientId, controlCode, true, uint32ToBytes(isStandby ? 1 : 0)); break;
+	case GET_SPECIFIC_MODE:    sendResponse(clientId, controlCode, true, uint32ToBytes(isFogMode ? 1 : 0)); break;
+	case GET_DEVICE_SERIAL:    sendResponse(clientId, controlCode, true, stringToBytes("EMU-" + address, 32)); break;
+	case GET_DEVICE_MODEL:     sendResponse(clientId, controlCode, true, stringToBytes("SL450 (emulated)", 32)); break;
+	case GET_FIRMWARE_VERSION: sendResponse(clientId, controlCode, true, stringToBytes("1.0.0", 16)); break;
+	case GET_LIDAR_WARNING: {
+		char warning[16] = "none";
+		if (faultCode != 0) snprintf(warning, sizeof(warning), "0x%04X", faultCode);
+		sendResponse(clientId, controlCode, true, stringToBytes(warning, 16));
+		break;
+	}
+	default: {
+		sendResponse(clientId, controlCode, false);
+		break;
+	}
+	}
+}
+
+void OrbbecEmulator::sendResponse(int clientId, uint16_t controlCode, bool isSuccess, const vector<uint8_t>& data) {
+	uint16_t responseCode = isSuccess ? RESPONSE_SUCCESS : RESPONSE_FAILURE;
+
+	response.clear();
+	response.insert(response.end(), {
+		0x01, 0xFE, 0x01,
+		(uint8_t)((data.size() >> 8) & 0xFF), (uint8_t)(data.size() & 0xFF),
+		(uint8_t)((controlCode >> 8) & 0xFF), (uint8_t)(controlCode & 0xFF),
+		(uint8_t)((responseCode >> 8) & 0xFF), (uint8_t)(responseCode & 0xFF)
+	});
+	response.insert(response.end(), data.begin(), data.end());
+	response.push_back(calculateCRC8(response.data(), response.size()));
+
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	if (unit(random) < faults.controlErrors) {
+		response.back() ^= 1;
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.corrupted++;
+	}
+
+	server.sendRawBytes(clientId, (const char*)response.data(), (int)response.size());
+}
+
+void OrbbecEmulator::updateFaults(float seconds) {
+	if (isStandby) return;
+
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	if (lidarState != 3 && unit(random) < faults.faultsPerMinute * seconds / 60.0f) {
+		static const uint16_t FAULT_CODES[] = { 0x0301, 0x0303, 0x0306, 0x0307, 0x0318 };
+		lidarState = 3;
+		faultCode = FAULT_CODES[random() % 5];
+		warningSeconds = 0;
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.faults++;
+	}
+
+	if (lidarState == 1 && unit(random) < faults.warningsPerMinute * seconds / 60.0f) {
+		// dirt level 1, clears by itself
+		lidarState = 2;
+		faultCode = 0x030C;
+		warningSeconds = 2.0f;
+	}
+
+	if (lidarState == 2) {
+		warningSeconds -= seconds;
+		if (warningSeconds <= 0) {
+			lidarState = 1;
+			faultCode = 0;
+		}
+	}
+}
+
+void OrbbecEmulator::streamBlocks(std::chrono::steady_clock::time_point now) {
+	while (true) {
+		// a block goes out once the head has swept past its last point
+		float blockEndAngle = (FIRST_ANGLE + (nextBlock + 1) * BLOCK_ANGLE) * 0.01f;
+
+		if (nextBlock < BLOCKS_PER_SCAN && rotationAngle >= blockEndAngle) {
+			if (nextBlock == 0) {
+				const SpeedMode& mode = speedMode();
+				scan.resize(BLOCKS_PER_SCAN * mode.pointsPerBlock);
+
+				// the field of view is centered on 180 degrees, the front of the head
+				float stepAngle = ofDegToRad(mode.angularResolution * 0.001f);
+				float startAngle = ofDegToRad((FIRST_ANGLE - 18000) * 0.01f);
+				uint64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(now - startTime).count();
+				source->fill(scan, startAngle, stepAngle, timeUs);
+			}
+
+			buildBlock(nextBlock);
+			for (auto& [clientId, client] : clients) {
+				if (isStreamEnabled && client.isConnected) sendBlock(clientId, client);
+			}
+			nextBlock++;
+		} else if (rotationAngle >= 360.0f) {
+			rotationAngle -= 360.0f;
+			nextBlock = 0;
+			revolution++;
+		} else {
+			break;
+		}
+	}
+}
+
+void OrbbecEmulator::buildBlock(int block) {
+	const SpeedMode& mode = speedMode();
+
+	uint16_t startAngle = FIRST_ANGLE + block * BLOCK_ANGLE;
+	uint16_t endAngle = startAngle + (mode.pointsPerBlock - 1) * mode.angularResolution / 10;
+	uint16_t frameLength = HEADER_LENGTH + mode.pointsPerBlock * 4 + 4;
+	uint32_t timestamp = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+	std::uniform_int_distribution<int> jitter(-3, 3);
+	uint16_t rotationSpeed = motorSpeed + jitter(random);
+	uint16_t temperature = 4200 + revolution % 50;
+
+	frame.assign(frameLength, 0);
+	uint8_t* data = frame.data();
+
+	const uint8_t FRAME_HEADER[] = { 0x4D, 0x53, 0x02, 0xF4, 0xEB, 0x90 };
+	memcpy(data, FRAME_HEADER, sizeof(FRAME_HEADER));
+
+	auto putUint16 = [&](int offset, uint16_t value) {
+		data[offset] = (value >> 8) & 0xFF;
+		data[offset + 1] = value & 0xFF;
+	};
+
+	putUint16(6, frameLength);
+	putUint16(8, startAngle);
+	putUint16(10, endAngle);
+	putUint16(12, mode.angularResolution);
+	data[14] = mode.infoType;
+	data[15] = BLOCKS_PER_SCAN;
+	putUint16(16, block);
+	putUint16(18, (timestamp >> 16) & 0xFFFF);
+	putUint16(20, timestamp & 0xFFFF);
+	data[24] = lidarState;
+	putUint16(25, faultCode);
+	putUint16(31, temperature);
+	putUint16(33, rotationSpeed);
+
+	// distance in 2 mm units, then intensity
+	const float* distances = scan.data() + block * mode.pointsPerBlock;
+	for (int i = 0; i < mode.pointsPerBlock; i++) {
+		int distance = std::min((int)(distances[i] * 0.5f), 0xFFFF);
+		putUint16(HEADER_LENGTH + i * 4, distance);
+		putUint16(HEADER_LENGTH + i * 4 + 2, distance > 0 ? 200 : 0);
+	}
+
+	memset(data + frameLength - 4, 0xFE, 4);
+}
+
+void OrbbecEmulator::sendBlock(int clientId, Client& client) {
+	size_t length = frame.size();
+
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::lock_guard<std::mutex> lock(statsMutex);
+
+		if (unit(random) < faults.drops) {
+			stats.dropped++;
+			return;
+		}
+
+		// a torn block runs into the next one, the client has to resynchronize
+		if (unit(random) < faults.partials) {
+			length = 1 + random() % (length - 1);
+			stats.torn++;
+		}
+
+		stats.frames++;
+		stats.bytes += length;
+	}
+
+	if (!isUdp) {
+		server.sendRawBytes(clientId, (const char*)frame.data(), (int)length);
+		return;
+	}
+
+	// in UDP mode every block is its own datagram, sent back to the client's address
+	if (!client.udp) {
+		client.udp = std::make_unique<ofxUDPManager>();
+		client.udp->Create();
+		client.udp->SetNonBlocking(true);
+		client.udp->Connect(server.getClientIP(clientId).c_str(), udpPort);
+	}
+	client.udp->Send((const char*)frame.data(), (int)length);
+}
+
+vector<uint8_t> OrbbecEmulator::uint32ToBytes(uint32_t value) {
+	return {
+		(uint8_t)((value >> 24) & 0xFF),
+		(uint8_t)((value >> 16) & 0xFF),
+		(uint8_t)((value >> 8) & 0xFF),
+		(uint8_t)(value & 0xFF)
+	};
+}
+
+vector<uint8_t> OrbbecEmulator::stringToBytes(const string& value, size_t length) {
+	// fixed width and zero padded, as the head reports its strings
+	vector<uint8_t> bytes(length, 0);
+	std::copy_n(value.begin(), std::min(value.size(), length), bytes.begin());
+	return bytes;
+}
+
+uint8_t OrbbecEmulator::calculateCRC8(const uint8_t* data, size_t length) {
+	static const uint8_t CrcTable[256] = {
+		0x00, 0x4d, 0x9a, 0xd7, 0x79, 0x34, 0xe3, 0xae, 0xf2, 0xbf, 0x68, 0x25, 0x8b, 0xc6, 0x11, 0x5c, 0xa9, 0xe4, 0x33, 0x7e, 0xd0, 0x9d, 0x4a, 0x07, 0x5b, 0x16, 0xc1, 0x8c, 0x22, 0x6f, 0xb8, 0xf5, 0x1f, 0x52, 0x85, 0xc8, 0x66, 0x2b, 0xfc, 0xb1, 0xed, 0xa0, 0x77, 0x3a, 0x94, 0xd9, 0x0e, 0x43, 0xb6, 0xfb, 0x2c, 0x61, 0xcf, 0x82, 0x55, 0x18, 0x44, 0x09, 0xde, 0x93, 0x3d, 0x70, 0xa7, 0xea, 0x3e, 0x73, 0xa4, 0xe9, 0x47, 0x0a, 0xdd, 0x90, 0xcc, 0x81, 0x56, 0x1b, 0xb5, 0xf8, 0x2f, 0x62, 0x97, 0xda, 0x0d, 0x40, 0xee, 0xa3, 0x74, 0x39, 0x65, 0x28, 0xff, 0xb2, 0x1c, 0x51, 0x86, 0xcb, 0x21, 0x6c, 0xbb, 0xf6, 0x58, 0x15, 0xc2, 0x8f, 0xd3, 0x9e, 0x49, 0x04, 0xaa, 0xe7, 0x30, 0x7d, 0x88, 0xc5, 0x12, 0x5f, 0xf1, 0xbc, 0x6b, 0x26, 0x7a, 0x37, 0xe0, 0xad, 0x03, 0x4e, 0x99, 0xd4, 0x7c, 0x31, 0xe6, 0xab, 0x05, 0x48, 0x9f, 0xd2, 0x8e, 0xc3, 0x14, 0x59, 0xf7, 0xba, 0x6d, 0x20, 0xd5, 0x98, 0x4f, 0x02, 0xac, 0xe1, 0x36, 0x7b, 0x27, 0x6a, 0xbd, 0xf0, 0x5e, 0x13, 0xc4, 0x89, 0x63, 0x2e, 0xf9, 0xb4, 0x1a, 0x57, 0x80, 0xcd, 0x91, 0xdc, 0x0b, 0x46, 0xe8, 0xa5, 0x72, 0x3f, 0xca, 0x87, 0x50, 0x1d, 0xb3, 0xfe, 0x29, 0x64, 0x38, 0x75, 0xa2, 0xef, 0x41, 0x0c, 0xdb, 0x96, 0x42, 0x0f, 0xd8, 0x95, 0x3b, 0x76, 0xa1, 0xec, 0xb0, 0xfd, 0x2a, 0x67, 0xc9, 0x84, 0x53, 0x1e, 0xeb, 0xa6, 0x71, 0x3c, 0x92, 0xdf, 0x08, 0x45, 0x19, 0x54, 0x83, 0xce, 0x60, 0x2d, 0xfa, 0xb7, 0x5d, 0x10, 0xc7, 0x8a, 0x24, 0x69, 0xbe, 0xf3, 0xaf, 0xe2, 0x35, 0x78, 0xd6, 0x9b, 0x4c, 0x01, 0xf4, 0xb9, 0x6e, 0x23, 0x8d, 0xc0, 0x17, 0x5a, 0x06, 0x4b, 0x9c, 0xd1, 0x7f, 0x32, 0xe5, 0xa8
+	};
+
+	uint8_t crc = 0;
+	for (size_t i = 0; i < length; ++i) {
+		crc = CrcTable[(crc ^ data[i]) & 0xff];
+	}
+	return crc;
+}
@@ -0,0 +1,138 @@
+//
+//  OrbbecEmulator.hpp
+//  orbbecEmulator
+
+#ifndef OrbbecEmulator_hpp
+#define OrbbecEmulator_hpp
+
+#include <stdio.h>
+#include <random>
+#include "ofMain.h"
+#include "ofxNetwork.h"
+#include "ScanSource.hpp"
+
+// one emulated Pulsar SL450 on its own address, answering the control registers
+// meatbags' OrbbecPulsar reads and writes and streaming block sequenced point
+// cloud frames over TCP, or over UDP when the transmission protocol is set to it
+class OrbbecEmulator : public ofThread {
+public:
+	// drops and partials are per block, faults and warnings are per minute of ranging
+	struct Faults {
+		float drops = 0;
+		float partials = 0;
+		float controlErrors = 0;
+		float faultsPerMinute = 0;
+		float warningsPerMinute = 0;
+	};
+
+	struct Stats {
+		int clients = 0;
+		int frames = 0;
+		size_t bytes = 0;
+		int dropped = 0;
+		int torn = 0;
+		int corrupted = 0;
+		int faults = 0;
+		int resets = 0;
+	};
+
+	OrbbecEmulator();
+	~OrbbecEmulator();
+
+	bool setup(const string& address, int port, std::unique_ptr<ScanSource> source, int seed);
+	void stop();
+
+	// counters since the previous call
+	Stats takeStats();
+
+	string address;
+	int udpPort;
+	bool isUdp;
+	Faults faults;
+
+private:
+	struct Client {
+		vector<uint8_t> input;
+		bool isConnected = false;
+		std::unique_ptr<ofxUDPManager> udp;
+	};
+
+	void threadedFunction() override;
+	void receiveCommands(int clientId, Client& client);
+	void handleCommand(int clientId, Client& client, const uint8_t* command, size_t length);
+	void sendResponse(int clientId, uint16_t controlCode, bool isSuccess, const vector<uint8_t>& data = {});
+
+	void updateFaults(float seconds);
+	void streamBlocks(std::chrono::steady_clock::time_point now);
+	void buildBlock(int block);
+	void sendBlock(int clientId, Client& client);
+
+	vector<uint8_t> uint32ToBytes(uint32_t value);
+	vector<uint8_t> stringToBytes(const string& value, size_t length);
+	uint8_t calculateCRC8(const uint8_t* data, size_t length);
+
+	ofxTCPServer server;
+	std::map<int, Client> clients;
+	std::unique_ptr<ScanSource> source;
+	vector<float> scan;
+	vector<uint8_t> frame;
+	vector<uint8_t> response;
+	std::mt19937 random;
+	std::chrono::steady_clock::time_point startTime, lastUpdateTime;
+
+	// device registers
+	uint32_t motorSpeed;
+	bool isStandby;
+	bool isFogMode;
+	bool isStreamEnabled;
+
+	// a fault holds until the head is cycled through standby, like the real one
+	int lidarState;
+	uint16_t faultCode;
+	float warningSeconds;
+
+	// revolution currently being streamed, the angle is in degrees
+	uint64_t revolution;
+	int nextBlock;
+	float rotationAngle;
+
+	std::mutex statsMutex;
+	Stats stats;
+
+	// REG_SET_MOTOR_SPEED rpm, and the block layout each speed streams. every
+	// speed splits the 270 degree field of view into 18 blocks of 15 degrees
+	struct SpeedMode {
+		uint32_t rpm;
+		uint8_t infoType;
+		int pointsPerBlock;
+		int angularResolution;   // 0.001 degrees
+	};
+	static const SpeedMode SPEED_MODES[5];
+	const SpeedMode& speedMode() const;
+
+	static constexpr int BLOCKS_PER_SCAN = 18;
+	static constexpr int FIRST_ANGLE = 4500;   // 0.01 degrees
+	static constexpr int BLOCK_ANGLE = 1500;   // 0.01 degrees
+	static constexpr int HEADER_LENGTH = 40;
+
+	static constexpr uint16_t GET_MOTOR_SPEED = 0x0205;
+	static constexpr uint16_t GET_TRANS_PROTOCOL = 0x0207;
+	static constexpr uint16_t GET_WORKING_MODE = 0x0208;
+	static constexpr uint16_t GET_DEVICE_SERIAL = 0x0209;
+	static constexpr uint16_t GET_DEVICE_MODEL = 0x020A;
+	static constexpr uint16_t GET_FIRMWARE_VERSION = 0x020B;
+	static constexpr uint16_t GET_LIDAR_WARNING = 0x020E;
+	static constexpr uint16_t GET_SPECIFIC_MODE = 0x0217;
+
+	static constexpr uint16_t REG_CONNECT_DEVICE = 0x0109;
+	static constexpr uint16_t REG_SET_DATA_STREAM = 0x010F;
+	static constexpr uint16_t REG_SET_MOTOR_SPEED = 0x0105;
+	static constexpr uint16_t REG_SET_WORKING_MODE = 0x0108;
+	static constexpr uint16_t REG_SET_TCP_MODE = 0x0107;
+	static constexpr uint16_t REG_SET_SPECIAL_WORKING_MODE = 0x0110;
+
+	static constexpr uint16_t RESPONSE_SUCCESS = 0x0100;
+	static constexpr uint16_t RESPONSE_FAILURE = 0x0200;
+};
+
+#endif /* OrbbecEmulator_hpp */
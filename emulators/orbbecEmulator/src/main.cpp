@@ -0,0 +1,141 @@
+//
+//  main.cpp
+//  orbbecEmulator
+
+#include "ofMain.h"
+#include "OrbbecEmulator.hpp"
+#include <csignal>
+
+// emulates a rig of Orbbec Pulsar SL450 sensors on consecutive loopback addresses,
+// 127.0.0.1, 127.0.0.2, ... all on the control port, so meatbags connects to them
+// exactly as it would to real sensors
+
+static std::atomic<bool> isRunning{ true };
+
+static void printUsage() {
+	std::cout
+		<< "usage: orbbecEmulator [options]\n"
+		<< "  --sensors N              emulated sensors, one address each (1)\n"
+		<< "  --address IP             first address, later sensors count up (127.0.0.1)\n"
+		<< "  --port PORT              control and TCP data port (2228)\n"
+		<< "  --udp                    start in UDP transmission mode\n"
+		<< "  --udp-port PORT          port UDP blocks are sent to on the client (2228)\n"
+		<< "  --people N               people walking around each synthetic sensor (8)\n"
+		<< "  --recording PATH         replay a .mbscan, or sensor_<n>.mbscan from a folder\n"
+		<< "  --drops P                probability a block is not sent (0)\n"
+		<< "  --partial P              probability a block is cut short (0)\n"
+		<< "  --control-errors P       probability a control response fails its CRC (0)\n"
+		<< "  --faults N               error states per sensor per minute, held until standby (0)\n"
+		<< "  --warnings N             two second warning states per sensor per minute (0)\n";
+}
+
+int main(int argc, char* argv[]) {
+	int numberSensors = 1;
+	string address = "127.0.0.1";
+	int port = 2228;
+	int udpPort = 2228;
+	bool isUdp = false;
+	int numberPeople = 8;
+	string recording;
+	OrbbecEmulator::Faults faults;
+
+	for (int i = 1; i < argc; i++) {
+		string option = argv[i];
+		if (option == "--help") {
+			printUsage();
+			return 0;
+		}
+		if (option == "--udp") {
+			isUdp = true;
+			continue;
+		}
+
+		if (i + 1 >= argc) {
+			printUsage();
+			return 1;
+		}
+		string value = argv[++i];
+
+		if (option == "--sensors")             numberSensors = ofToInt(value);
+		else if (option == "--address")        address = value;
+		else if (option == "--port")           port = ofToInt(value);
+		else if (option == "--udp-port")       udpPort = ofToInt(value);
+		else if (option == "--people")         numberPeople = ofToInt(value);
+		else if (option == "--recording")      recording = value;
+		else if (option == "--drops")          faults.drops = ofToFloat(value);
+		else if (option == "--partial")        faults.partials = ofToFloat(value);
+		else if (option == "--control-errors") faults.controlErrors = ofToFloat(value);
+		else if (option == "--faults")         faults.faultsPerMinute = ofToFloat(value);
+		else if (option == "--warnings")       faults.warningsPerMinute = ofToFloat(value);
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	vector<string> octets = ofSplitString(address, ".");
+	if (octets.size() != 4) {
+		ofLogError("orbbecEmulator") << "Invalid address " << address;
+		return 1;
+	}
+
+	std::signal(SIGINT, [](int) { isRunning = false; });
+
+	vector<std::unique_ptr<OrbbecEmulator>> emulators;
+	for (int i = 0; i < numberSensors; i++) {
+		string sensorAddress = octets[0] + "." + octets[1] + "." + octets[2] + "." + ofToString(ofToInt(octets[3]) + i);
+
+		std::unique_ptr<ScanSource> source;
+		if (recording.empty()) {
+			source = std::make_unique<SyntheticSource>(i + 1, numberPeople);
+		} else {
+			bool isFile = ofIsStringInString(recording, ScanFile::EXTENSION);
+			string path = isFile ? recording : recording + "/sensor_" + ofToString(i + 1) + ScanFile::EXTENSION;
+
+			auto recordingSource = std::make_unique<RecordingSource>();
+			if (!recordingSource->load(path)) return 1;
+			source = std::move(recordingSource);
+		}
+
+		auto emulator = std::make_unique<OrbbecEmulator>();
+		emulator->isUdp = isUdp;
+		emulator->udpPort = udpPort;
+		emulator->faults = faults;
+		if (!emulator->setup(sensorAddress, port, std::move(source), i + 1)) return 1;
+
+		emulators.push_back(std::move(emulator));
+	}
+
+	// one line a second, summed over every sensor
+	while (isRunning) {
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+
+		OrbbecEmulator::Stats total;
+		for (auto& emulator : emulators) {
+			OrbbecEmulator::Stats stats = emulator->takeStats();
+			total.clients   += stats.clients;
+			total.frames    += stats.frames;
+			total.bytes     += stats.bytes;
+			total.dropped   += stats.dropped;
+			total.torn      += stats.torn;
+			total.corrupted += stats.corrupted;
+			total.faults    += stats.faults;
+			total.resets    += stats.resets;
+		}
+
+		std::cout << "clients " << total.clients
+				  << "  blocks/s " << total.frames
+				  << "  MB/s " << ofToString(total.bytes / 1000000.0, 2)
+				  << "  dropped " << total.dropped
+				  << "  torn " << total.torn
+				  << "  corrupted " << total.corrupted
+				  << "  faults " << total.faults
+				  << "  resets " << total.resets << std::endl;
+	}
+
+	for (auto& emulator : emulators) {
+		emulator->stop();
+	}
+
+	return 0;
+}
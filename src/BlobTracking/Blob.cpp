@@ -10,20 +10,31 @@ Blob::Blob() {
 	lifetime = 0;
 	numberPoints = 0;
 	whichMeatbag = 0;
+	covarianceXX = 0;
+	covarianceXY = 0;
+	covarianceYY = 0;
+	orientation = 0;
 	velocity = ofPoint(0, 0);
+	positionVariance = 0;
+	positionVelocityCovariance = 0;
+	velocityVariance = 0;
 }
 
-Blob::Blob(vector<ofPoint> coordinates, vector<int> intensities, float blobPersistence, int _numberPoints) {
-	calculateCentroid(coordinates);
-	calculateBounds(coordinates);
-	calculateIntensity(intensities);
-	
+Blob::Blob(const ClusterMoments& moments, float blobPersistence) {
+	centroid = ofPoint(moments.getMeanX(), moments.getMeanY());
+	bounds = ofRectangle(moments.left, moments.top, moments.right - moments.left, moments.bottom - moments.top);
+	center = bounds.getCenter();
+	moments.getCovariance(covarianceXX, covarianceXY, covarianceYY);
+	orientation = moments.getOrientation();
+
+	// no sensor reports intensities for tracking yet
+	intensity = 0;
 	distanceFromSensor = centroid.length();
 	lifetimeLength = blobPersistence;
 	matched = false;
 	alive = true;
 	lifetime = 0;
-	numberPoints = _numberPoints;
+	numberPoints = moments.numberPoints;
 	velocity = ofPoint(0, 0);
 }
 
@@ -43,10 +54,14 @@ void Blob::become(Blob &_blob) {
 	center = _blob.center;
 	intensity = _blob.intensity;
 	bounds = _blob.bounds;
+	covarianceXX = _blob.covarianceXX;
+	covarianceXY = _blob.covarianceXY;
+	covarianceYY = _blob.covarianceYY;
+	orientation = _blob.orientation;
 	distanceFromSensor = _blob.distanceFromSensor;
 	numberPoints = _blob.numberPoints;
 	lifetimeLength = _blob.lifetimeLength;
-	// velocity is updated externally in Meatbags::matchBlobs, not copied here
+	// centroid and velocity are then smoothed by BlobTracker::correct, its state isn't copied
 }
 
 void Blob::setIndex(int _index) {
@@ -61,52 +76,3 @@ bool Blob::isMatched() {
 	return matched;
 }
 
-void Blob::setPotentialMatch(int _potentialMatchIndex, float _score) {
-	potentialMatchIndex = _potentialMatchIndex;
-	potentialMatchScore = _score;
-}
-
-void Blob::calculateCentroid(vector<ofPoint> &coordinates) {
-	float totalX = 0.0;
-	float totalY = 0.0;
-	
-	for (const auto& point : coordinates) {
-		totalX += point.x;
-		totalY += point.y;
-	}
-	
-	centroid = ofPoint(totalX / coordinates.size(), totalY / coordinates.size());
-}
-
-void Blob::calculateBounds(vector<ofPoint> &coordinates) {
-	float minX = std::numeric_limits<float>::max();
-	float maxX = std::numeric_limits<float>::lowest();
-	float minY = std::numeric_limits<float>::max();
-	float maxY = std::numeric_limits<float>::lowest();
-	
-	for (const auto& coordinate : coordinates) {
-		float x = coordinate.x;
-		float y = coordinate.y;;
-
-		if (x > maxX) maxX = x;
-		if (x < minX) minX = x;
-		if (y > maxY) maxY = y;
-		if (y < minY) minY = y;
-	}
-	
-	float rX = minX;
-	float rY = minY;
-	float rW = fabs(maxX - minX);
-	float rH = fabs(maxY - minY);
-		
-	bounds = ofRectangle(rX, rY, rW, rH);
-	center = ofPoint(rX + rW * 0.5, rY + rH * 0.5);
-}
-
-void Blob::calculateIntensity(vector<int> &intensities) {
-	int sum = 0;
-	for (int i = 0; i < intensities.size(); i++) {
-		sum += intensities[i];
-	}
-	intensity = (float)sum / intensities.size();
-}
@@ -8,37 +8,40 @@
 #include "ofMain.h"
 #include <stdio.h>
 #include <limits>
+#include "Clusterer.hpp"
 
 class Blob {
 public:
 	Blob();
-	Blob(vector<ofPoint> coordinates, vector<int> intensities, float blobPersistence, int numberPoints);
+	// statistics of a cluster, from the sums its clusterer added up
+	Blob(const ClusterMoments& moments, float blobPersistence);
 	void updateLifetime(float secondsLived);
 	void setMatched(bool matched);
 	bool isMatched();
 	bool isAlive();
 	void setIndex(int index);
-	void setPotentialMatch(int index, float score);
 	void become(Blob& blob);
 
 	ofPoint centroid, center;
-	ofPoint velocity;       // meters/second, EMA smoothed
+	ofPoint velocity;       // meters/second, from the tracker's estimate
 	ofRectangle bounds;
+	float covarianceXX, covarianceXY, covarianceYY;    // mm², the spread of the points
+	float orientation;      // radians, of the longer axis of the spread from the x axis
 	int numberPoints;
 	float intensity;
 	float distanceFromSensor;
 
-	int   potentialMatchIndex;
-	float potentialMatchScore;
 	float lifetime, lifetimeLength;
 
 	bool matched, alive;
 
+	// BlobTracker's constant velocity Kalman filter, in mm and mm/s. both axes share one
+	// covariance since they have the same noise. after a prediction, estimatedPosition is
+	// where the blob should be at this scan
+	ofVec2f estimatedPosition, estimatedVelocity;
+	float   positionVariance, positionVelocityCovariance, velocityVariance;
+
 	int index, whichMeatbag;
-private:
-	void calculateCentroid(vector<ofPoint>& coordinates);
-	void calculateBounds(vector<ofPoint>& coordinates);
-	void calculateIntensity(vector<int>& intensity);
 };
 
 #endif /* Blob_hpp */
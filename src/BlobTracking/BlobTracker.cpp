@@ -0,0 +1,239 @@
+//
+//  BlobTracker.cpp
+//  meatbags
+
+#include "BlobTracker.hpp"
+
+BlobTracker::BlobTracker() {
+	matchDistance = 0;
+	nextIndex = 0;
+	setNoise(2.0f, 0.05f);
+}
+
+void BlobTracker::setNoise(float processNoise, float measurementNoise) {
+	accelerationVariance = processNoise * 1000.0f * processNoise * 1000.0f;
+	measurementVariance = measurementNoise * 1000.0f * measurementNoise * 1000.0f;
+}
+
+void BlobTracker::predict(vector<Blob>& tracks, float deltaTime) {
+	float dt = deltaTime;
+	float dt2 = dt * dt;
+
+	// a random acceleration held over each interval, F = [1 dt; 0 1]
+	float q = accelerationVariance;
+	float q00 = q * dt2 * dt2 * 0.25f;
+	float q01 = q * dt2 * dt * 0.5f;
+	float q11 = q * dt2;
+
+	for (auto& track : tracks) {
+		track.estimatedPosition += track.estimatedVelocity * dt;
+
+		float p00 = track.positionVariance;
+		float p01 = track.positionVelocityCovariance;
+		float p11 = track.velocityVariance;
+		track.positionVariance = p00 + 2.0f * dt * p01 + dt2 * p11 + q00;
+		track.positionVelocityCovariance = p01 + dt * p11 + q01;
+		track.velocityVariance = p11 + q11;
+	}
+}
+
+void BlobTracker::correct(Blob& track, const ofPoint& measurement) {
+	float p00 = track.positionVariance;
+	float p01 = track.positionVelocityCovariance;
+	float p11 = track.velocityVariance;
+
+	float innovationVariance = p00 + measurementVariance;
+	float positionGain = p00 / innovationVariance;
+	float velocityGain = p01 / innovationVariance;
+
+	ofVec2f innovation(measurement.x - track.estimatedPosition.x, measurement.y - track.estimatedPosition.y);
+	track.estimatedPosition += innovation * positionGain;
+	track.estimatedVelocity += innovation * velocityGain;
+
+	track.positionVariance = (1.0f - positionGain) * p00;
+	track.positionVelocityCovariance = (1.0f - positionGain) * p01;
+	track.velocityVariance = p11 - velocityGain * p01;
+
+	track.centroid = ofPoint(track.estimatedPosition.x, track.estimatedPosition.y);
+	track.velocity = ofPoint(track.estimatedVelocity.x * 0.001f, track.estimatedVelocity.y * 0.001f);
+}
+
+void BlobTracker::start(Blob& track) {
+	track.estimatedPosition.set(track.centroid.x, track.centroid.y);
+	track.estimatedVelocity.set(0, 0);
+	track.positionVariance = measurementVariance;
+	track.positionVelocityCovariance = 0;
+	track.velocityVariance = INITIAL_SPEED_DEVIATION * INITIAL_SPEED_DEVIATION;
+	track.velocity = ofPoint(0, 0);
+}
+
+static inline int64_t getCellKey(int column, int row) {
+	return ((int64_t)row << 32) | (uint32_t)column;
+}
+
+void BlobTracker::match(const vector<Blob>& tracks, const vector<Blob>& detections,
+						float _matchDistance, vector<int>& assignments) {
+	matchDistance = std::max(_matchDistance, 1.0f);
+	assignments.assign(detections.size(), -1);
+	if (tracks.empty() || detections.empty()) return;
+
+	gate(tracks, detections);
+	assign(tracks.size(), detections.size(), assignments);
+}
+
+void BlobTracker::gate(const vector<Blob>& tracks, const vector<Blob>& detections) {
+	float inverseCellSize = 1.0f / matchDistance;
+	float matchDistanceSquared = matchDistance * matchDistance;
+
+	trackCells.resize(tracks.size());
+	for (int t = 0; t < tracks.size(); t++) {
+		const ofVec2f& prediction = tracks[t].estimatedPosition;
+		int column = (int)floor(prediction.x * inverseCellSize);
+		int row = (int)floor(prediction.y * inverseCellSize);
+		trackCells[t] = { getCellKey(column, row), t };
+	}
+	std::sort(trackCells.begin(), trackCells.end());
+
+	pairStarts.resize(detections.size() + 1);
+	pairTracks.clear();
+	pairCosts.clear();
+
+	for (int d = 0; d < detections.size(); d++) {
+		pairStarts[d] = pairTracks.size();
+
+		float x = detections[d].centroid.x;
+		float y = detections[d].centroid.y;
+		int column = (int)floor(x * inverseCellSize);
+		int row = (int)floor(y * inverseCellSize);
+
+		for (int neighborRow = row - 1; neighborRow <= row + 1; neighborRow++) {
+			for (int neighborColumn = column - 1; neighborColumn <= column + 1; neighborColumn++) {
+				TrackCell first = { getCellKey(neighborColumn, neighborRow), 0 };
+				auto it = std::lower_bound(trackCells.begin(), trackCells.end(), first);
+
+				for (; it != trackCells.end() && it->cell == first.cell; it++) {
+					const ofVec2f& prediction = tracks[it->track].estimatedPosition;
+					float dx = x - prediction.x;
+					float dy = y - prediction.y;
+					float distanceSquared = dx * dx + dy * dy;
+					if (distanceSquared > matchDistanceSquared) continue;
+
+					pairTracks.push_back(it->track);
+					pairCosts.push_back(distanceSquared);
+				}
+			}
+		}
+	}
+	pairStarts[detections.size()] = pairTracks.size();
+}
+
+void BlobTracker::assign(int numberTracks, int numberDetections, vector<int>& assignments) {
+	// leaving a detection unmatched costs as much as the worst pair allowed, so
+	// any match in range is never worse than none
+	double unmatchedCost = (double)matchDistance * matchDistance;
+	int numberColumns = numberTracks + numberDetections;
+
+	rowPotentials.assign(numberDetections, 0.0);
+	columnPotentials.assign(numberColumns, 0.0);
+	shortest.assign(numberColumns, std::numeric_limits<double>::infinity());
+	previousRows.assign(numberColumns, -1);
+	rowForColumn.assign(numberColumns, -1);
+	columnForRow.assign(numberDetections, -1);
+	isScanned.assign(numberColumns, 0);
+
+	auto isLater = [](const QueueEntry& a, const QueueEntry& b) {
+		return a.first > b.first || (a.first == b.first && a.second > b.second);
+	};
+
+	// one detection at a time, the cheapest path in reduced costs from it to a free
+	// column, found with Dijkstra over only the candidate pairs
+	for (int currentRow = 0; currentRow < numberDetections; currentRow++) {
+		scannedColumns.clear();
+		scannedRows.clear();
+		queue.clear();
+
+		double minimum = 0;
+		int row = currentRow;
+		int sink = -1;
+
+		while (sink == -1) {
+			scannedRows.push_back(row);
+
+			auto relax = [&](int column, double cost) {
+				if (isScanned[column]) return;
+				double reduced = minimum + cost - rowPotentials[row] - columnPotentials[column];
+				if (reduced < shortest[column]) {
+					shortest[column] = reduced;
+					previousRows[column] = row;
+					queue.push_back({ reduced, column });
+					std::push_heap(queue.begin(), queue.end(), isLater);
+				}
+			};
+
+			for (int p = pairStarts[row]; p < pairStarts[row + 1]; p++) {
+				relax(pairTracks[p], pairCosts[p]);
+			}
+			relax(numberTracks + row, unmatchedCost);
+
+			// the closest column not yet scanned, skipping stale entries
+			int column = -1;
+			while (!queue.empty()) {
+				std::pop_heap(queue.begin(), queue.end(), isLater);
+				QueueEntry entry = queue.back();
+				queue.pop_back();
+				if (!isScanned[entry.second] && entry.first == shortest[entry.second]) {
+					column = entry.second;
+					break;
+				}
+			}
+
+			// every row can reach its own unmatched column, so this always finds one
+			minimum = shortest[column];
+			isScanned[column] = 1;
+			scannedColumns.push_back(column);
+
+			if (rowForColumn[column] == -1) sink = column;
+			else row = rowForColumn[column];
+		}
+
+		// keep reduced costs non-negative for the next search
+		rowPotentials[currentRow] += minimum;
+		for (int i = 1; i < scannedRows.size(); i++) {
+			int scannedRow = scannedRows[i];
+			rowPotentials[scannedRow] += minimum - shortest[columnForRow[scannedRow]];
+		}
+		for (int column : scannedColumns) {
+			columnPotentials[column] -= minimum - shortest[column];
+		}
+
+		// flip the path
+		int column = sink;
+		while (true) {
+			int previousRow = previousRows[column];
+			rowForColumn[column] = previousRow;
+			std::swap(columnForRow[previousRow], column);
+			if (previousRow == currentRow) break;
+		}
+
+		// only what this search touched needs resetting
+		for (int column : scannedColumns) isScanned[column] = 0;
+		for (const auto& entry : queue) shortest[entry.second] = std::numeric_limits<double>::infinity();
+		for (int column : scannedColumns) shortest[column] = std::numeric_limits<double>::infinity();
+	}
+
+	for (int d = 0; d < numberDetections; d++) {
+		if (columnForRow[d] < numberTracks) assignments[d] = columnForRow[d];
+	}
+}
+
+int BlobTracker::allocateIndex() {
+	if (freeIndices.empty()) return nextIndex++;
+
+	int index = freeIndices.top();
+	freeIndices.pop();
+	return index;
+}
+
+void BlobTracker::releaseIndex(int index) {
+	freeIndices.push(index);
+}
@@ -0,0 +1,89 @@
+//
+//  BlobTracker.hpp
+//  meatbags
+
+#ifndef BlobTracker_hpp
+#define BlobTracker_hpp
+
+#include "ofMain.h"
+#include "Blob.hpp"
+#include <queue>
+
+// follows each track with a constant velocity Kalman filter, matches each scan's
+// blobs to the tracks, and hands out their ids. only pairs within the match distance
+// of where a track's filter predicts it to be are considered, found through a grid
+// of those predictions. the pairs are then assigned all at once,
+// for the smallest total squared distance, instead of each blob taking its nearest
+// track in turn, so two people passing each other keep their ids
+class BlobTracker {
+public:
+	BlobTracker();
+
+	// processNoise is the spread of the acceleration in m/s², measurementNoise
+	// the spread of a blob's centroid around the person in m
+	void setNoise(float processNoise, float measurementNoise);
+
+	// moves every track's estimate deltaTime seconds ahead
+	void predict(vector<Blob>& tracks, float deltaTime);
+
+	// assignments[d] is the index in tracks matched to detections[d], or -1.
+	// matchDistance is in mm
+	void match(const vector<Blob>& tracks, const vector<Blob>& detections,
+			   float matchDistance, vector<int>& assignments);
+
+	// folds in a matched blob's centroid, then sets the track's centroid and velocity from the estimate
+	void correct(Blob& track, const ofPoint& measurement);
+
+	// a new track at rest where it was first seen
+	void start(Blob& track);
+
+	// the lowest id not in use, as ids were given out before
+	int  allocateIndex();
+	void releaseIndex(int index);
+
+private:
+	void gate(const vector<Blob>& tracks, const vector<Blob>& detections);
+	void assign(int numberTracks, int numberDetections, vector<int>& assignments);
+
+	float matchDistance;
+
+	// variances in mm², and the acceleration's in (mm/s²)²
+	float accelerationVariance;
+	float measurementVariance;
+
+	// where each track should be by now, sorted into cells a match distance wide
+	struct TrackCell {
+		int64_t cell;
+		int     track;
+		bool operator<(const TrackCell& other) const {
+			return cell < other.cell || (cell == other.cell && track < other.track);
+		}
+	};
+	vector<TrackCell> trackCells;
+
+	// candidate pairs, detection d's are pairTracks[pairStarts[d]] up to pairStarts[d + 1]
+	vector<int>    pairStarts;
+	vector<int>    pairTracks;
+	vector<double> pairCosts;
+
+	// shortest augmenting paths over the candidate pairs. columns are the tracks, then
+	// one for each detection standing for leaving it unmatched, at the gate's cost
+	vector<double> rowPotentials, columnPotentials;
+	vector<double> shortest;
+	vector<int>    previousRows;
+	vector<int>    rowForColumn, columnForRow;
+	vector<int>    scannedColumns, scannedRows;
+	vector<uint8_t> isScanned;
+
+	typedef std::pair<double, int> QueueEntry;
+	vector<QueueEntry> queue;
+
+	// how unsure a new track's speed is, in mm/s, about a brisk walk
+	static constexpr float INITIAL_SPEED_DEVIATION = 1500.0f;
+
+	// ids given back, lowest first, and the next id never used
+	std::priority_queue<int, vector<int>, std::greater<int>> freeIndices;
+	int nextIndex;
+};
+
+#endif /* BlobTracker_hpp */
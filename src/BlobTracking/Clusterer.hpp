@@ -7,14 +7,103 @@
 
 #include <vector>
 #include <string>
+#include <limits>
+#include <cmath>
 #include "dbscan.hpp"
+#include "PointBuffer.h"
+#include "WorkerPool.hpp"
+
+// sums over a cluster's points, added up as the clusterer writes out each index.
+// enough for the centroid, bounds, spread and orientation without another pass
+struct ClusterMoments {
+    int    numberPoints = 0;
+    double sumX = 0, sumY = 0;
+    double sumXX = 0, sumXY = 0, sumYY = 0;
+    float  left   = std::numeric_limits<float>::max();
+    float  top    = std::numeric_limits<float>::max();
+    float  right  = std::numeric_limits<float>::lowest();
+    float  bottom = std::numeric_limits<float>::lowest();
+
+    inline void add(float x, float y) {
+        numberPoints++;
+        sumX += x;
+        sumY += y;
+        sumXX += (double)x * x;
+        sumXY += (double)x * y;
+        sumYY += (double)y * y;
+        left = std::min(left, x);
+        top = std::min(top, y);
+        right = std::max(right, x);
+        bottom = std::max(bottom, y);
+    }
+
+    float getMeanX() const { return sumX / numberPoints; }
+    float getMeanY() const { return sumY / numberPoints; }
+
+    // of the points about their mean, in mm²
+    void getCovariance(float& xx, float& xy, float& yy) const {
+        double meanX = sumX / numberPoints;
+        double meanY = sumY / numberPoints;
+        xx = std::max(sumXX / numberPoints - meanX * meanX, 0.0);
+        xy = sumXY / numberPoints - meanX * meanY;
+        yy = std::max(sumYY / numberPoints - meanY * meanY, 0.0);
+    }
+
+    // of the longer axis of the spread from the x axis, in radians between -pi/2 and pi/2
+    float getOrientation() const {
+        float xx, xy, yy;
+        getCovariance(xx, xy, yy);
+        return 0.5f * atan2(2.0f * xy, xx - yy);
+    }
+};
+
+// every cluster's point indices in one array, cluster c is indices[offsets[c]] up to
+// indices[offsets[c + 1]], and its moments. kept by the caller and refilled each scan,
+// so once it has grown to the busiest scan nothing is allocated
+struct ClusterList {
+    std::vector<int> indices;
+    std::vector<int> offsets = { 0 };
+    std::vector<ClusterMoments> moments;
+
+    void clear() {
+        indices.clear();
+        offsets.resize(1);
+        moments.clear();
+    }
+
+    int size() const { return offsets.size() - 1; }
+    int getNumberPoints(int c) const { return offsets[c + 1] - offsets[c]; }
+    const int* getIndices(int c) const { return indices.data() + offsets[c]; }
+
+    // the indices pushed since the last call make up the next cluster
+    void closeCluster() { offsets.push_back(indices.size()); }
+};
 
 class Clusterer {
 public:
     virtual ~Clusterer() = default;
-    virtual std::vector<std::vector<int>> cluster(const std::vector<point2>& points) = 0;
+    virtual void cluster(const PointBuffer& points, ClusterList& clusters) = 0;
     virtual void setParameters(float epsilon, int minPoints) {}
     virtual std::string getName() = 0;
+
+    // clusterers that split their work across cores use the tracking thread's workers
+    void setWorkerPool(WorkerPool* _workerPool) { workerPool = _workerPool; }
+
+protected:
+    // one part per core, once a scan has enough points to be worth sharing
+    int getNumberParts(int numberPoints) const {
+        if (!workerPool || numberPoints < MIN_PARALLEL_POINTS) return 1;
+        return workerPool->getNumberWorkers() + 1;
+    }
+
+    void runParts(int numberParts, const WorkerPool::Task& task) {
+        if (numberParts > 1) workerPool->run(numberParts, task);
+        else task(0);
+    }
+
+    WorkerPool* workerPool = nullptr;
+
+    static const int MIN_PARALLEL_POINTS = 2000;
 };
 
 #endif /* Clusterer_hpp */
\ No newline at end of file
@@ -0,0 +1,237 @@
+//
+//  DBSCANClusterer.cpp
+//  meatbags
+
+#include "DBSCANClusterer.hpp"
+
+void DBSCANClusterer::cluster(const PointBuffer& points, ClusterList& clusters) {
+	int n = points.numberPoints;
+	clusters.clear();
+	if (n == 0) return;
+
+	// strictly within epsilon, the point itself counting toward minPoints
+	epsilonSquared = epsilon * epsilon;
+	grid.build(points, epsilon);
+
+	int numberBands = grid.splitRows(getNumberParts(n), bandRows);
+
+	isCore.resize(n);
+	parents.resize(n);
+	roots.resize(n);
+	for (int i = 0; i < n; i++) parents[i] = i;
+
+	runParts(numberBands, [this](int b) {
+		markCorePoints(bandRows[b], bandRows[b + 1]);
+	});
+
+	// each band only joins points within its own rows, so no two bands touch
+	// the same part of the union-find
+	runParts(numberBands, [this](int b) {
+		joinCorePoints(bandRows[b], bandRows[b + 1]);
+	});
+
+	// then the last row of each band with the first row of the next
+	for (int b = 1; b < numberBands; b++) {
+		joinSeam(bandRows[b] - 1);
+	}
+
+	// every link points to a lower index, so one ascending pass finds all roots
+	for (int i = 0; i < n; i++) {
+		if (!isCore[i]) roots[i] = -1;
+		else roots[i] = parents[i] == i ? i : roots[parents[i]];
+	}
+
+	runParts(numberBands, [this](int b) {
+		findBorderRoots(bandRows[b], bandRows[b + 1]);
+	});
+
+	// clusters numbered by their lowest core point, same as a serial DBSCAN
+	labels.resize(n);
+	sizes.clear();
+	for (int i = 0; i < n; i++) {
+		if (roots[i] == i) {
+			labels[i] = sizes.size();
+			sizes.push_back(0);
+		}
+	}
+	for (int i = 0; i < n; i++) {
+		if (roots[i] >= 0) sizes[labels[roots[i]]]++;
+	}
+
+	int numberClusters = sizes.size();
+	int numberIndices = 0;
+	clusterStarts.resize(numberClusters);
+	for (int c = 0; c < numberClusters; c++) {
+		clusterStarts[c] = numberIndices;
+		numberIndices += sizes[c];
+		clusters.offsets.push_back(numberIndices);
+	}
+
+	// each cluster's indices in ascending order, its moments summed along the way
+	clusters.indices.resize(numberIndices);
+	clusters.moments.resize(numberClusters);
+	for (int i = 0; i < n; i++) {
+		if (roots[i] < 0) continue;
+		int c = labels[roots[i]];
+		clusters.indices[clusterStarts[c]++] = i;
+		clusters.moments[c].add(points.x[i], points.y[i]);
+	}
+}
+
+void DBSCANClusterer::markCorePoints(int firstRow, int lastRow) {
+	const std::vector<int>& cellStarts = grid.cellStarts;
+	const std::vector<float>& sortedX = grid.sortedX;
+	const std::vector<float>& sortedY = grid.sortedY;
+
+	for (int row = firstRow; row < lastRow; row++) {
+		int firstNeighborRow = std::max(row - 1, 0);
+		int lastNeighborRow = std::min(row + 1, grid.numberRows - 1);
+
+		for (int column = 0; column < grid.numberColumns; column++) {
+			int cell = grid.getCell(column, row);
+			int firstNeighborColumn = std::max(column - 1, 0);
+			int lastNeighborColumn = std::min(column + 1, grid.numberColumns - 1);
+
+			for (int a = cellStarts[cell]; a < cellStarts[cell + 1]; a++) {
+				float x = sortedX[a];
+				float y = sortedY[a];
+				int count = 0;
+
+				for (int neighborRow = firstNeighborRow; neighborRow <= lastNeighborRow && count < minPoints; neighborRow++) {
+					int first = cellStarts[grid.getCell(firstNeighborColumn, neighborRow)];
+					int last = cellStarts[grid.getCell(lastNeighborColumn, neighborRow) + 1];
+
+					// a row's three neighbor cells are next to each other in sorted order
+					for (int b = first; b < last && count < minPoints; b++) {
+						float dx = x - sortedX[b];
+						float dy = y - sortedY[b];
+						if (dx * dx + dy * dy < epsilonSquared) count++;
+					}
+				}
+
+				isCore[grid.sortedIndices[a]] = count >= minPoints;
+			}
+		}
+	}
+}
+
+void DBSCANClusterer::joinCorePoints(int firstRow, int lastRow) {
+	for (int row = firstRow; row < lastRow; row++) {
+		for (int column = 0; column < grid.numberColumns; column++) {
+			int cell = grid.getCell(column, row);
+			if (grid.cellStarts[cell] == grid.cellStarts[cell + 1]) continue;
+
+			// the rest of the cell and the neighbors ahead of it, so each pair of
+			// cells is compared once
+			joinCells(cell, cell);
+			if (column + 1 < grid.numberColumns) joinCells(cell, cell + 1);
+			if (row + 1 < lastRow) joinNextRow(column, row);
+		}
+	}
+}
+
+void DBSCANClusterer::joinSeam(int row) {
+	for (int column = 0; column < grid.numberColumns; column++) {
+		int cell = grid.getCell(column, row);
+		if (grid.cellStarts[cell] == grid.cellStarts[cell + 1]) continue;
+		joinNextRow(column, row);
+	}
+}
+
+void DBSCANClusterer::joinNextRow(int column, int row) {
+	int cell = grid.getCell(column, row);
+	int firstColumn = std::max(column - 1, 0);
+	int lastColumn = std::min(column + 1, grid.numberColumns - 1);
+
+	for (int neighborColumn = firstColumn; neighborColumn <= lastColumn; neighborColumn++) {
+		joinCells(cell, grid.getCell(neighborColumn, row + 1));
+	}
+}
+
+void DBSCANClusterer::joinCells(int cell, int neighbor) {
+	const std::vector<int>& cellStarts = grid.cellStarts;
+	const std::vector<int>& sortedIndices = grid.sortedIndices;
+	const std::vector<float>& sortedX = grid.sortedX;
+	const std::vector<float>& sortedY = grid.sortedY;
+
+	for (int a = cellStarts[cell]; a < cellStarts[cell + 1]; a++) {
+		int i = sortedIndices[a];
+		if (!isCore[i]) continue;
+
+		float x = sortedX[a];
+		float y = sortedY[a];
+
+		int first = cell == neighbor ? a + 1 : cellStarts[neighbor];
+		for (int b = first; b < cellStarts[neighbor + 1]; b++) {
+			int j = sortedIndices[b];
+			if (!isCore[j]) continue;
+
+			float dx = x - sortedX[b];
+			float dy = y - sortedY[b];
+			if (dx * dx + dy * dy < epsilonSquared) join(i, j);
+		}
+	}
+}
+
+void DBSCANClusterer::findBorderRoots(int firstRow, int lastRow) {
+	const std::vector<int>& cellStarts = grid.cellStarts;
+	const std::vector<int>& sortedIndices = grid.sortedIndices;
+	const std::vector<float>& sortedX = grid.sortedX;
+	const std::vector<float>& sortedY = grid.sortedY;
+
+	for (int row = firstRow; row < lastRow; row++) {
+		int firstNeighborRow = std::max(row - 1, 0);
+		int lastNeighborRow = std::min(row + 1, grid.numberRows - 1);
+
+		for (int column = 0; column < grid.numberColumns; column++) {
+			int cell = grid.getCell(column, row);
+			int firstNeighborColumn = std::max(column - 1, 0);
+			int lastNeighborColumn = std::min(column + 1, grid.numberColumns - 1);
+
+			for (int a = cellStarts[cell]; a < cellStarts[cell + 1]; a++) {
+				int i = sortedIndices[a];
+				if (isCore[i]) continue;
+
+				float x = sortedX[a];
+				float y = sortedY[a];
+				int earliestRoot = -1;
+
+				for (int neighborRow = firstNeighborRow; neighborRow <= lastNeighborRow; neighborRow++) {
+					int first = cellStarts[grid.getCell(firstNeighborColumn, neighborRow)];
+					int last = cellStarts[grid.getCell(lastNeighborColumn, neighborRow) + 1];
+
+					for (int b = first; b < last; b++) {
+						int j = sortedIndices[b];
+						if (!isCore[j]) continue;
+						if (earliestRoot >= 0 && roots[j] >= earliestRoot) continue;
+
+						float dx = x - sortedX[b];
+						float dy = y - sortedY[b];
+						if (dx * dx + dy * dy < epsilonSquared) earliestRoot = roots[j];
+					}
+				}
+
+				// only this point's entry is written, core entries are only read
+				roots[i] = earliestRoot;
+			}
+		}
+	}
+}
+
+int DBSCANClusterer::findRoot(int i) {
+	while (parents[i] != i) {
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+void DBSCANClusterer::join(int a, int b) {
+	a = findRoot(a);
+	b = findRoot(b);
+	if (a == b) return;
+
+	// the lower index stays the root, so a cluster's root is its lowest core point
+	if (a < b) parents[b] = a;
+	else parents[a] = b;
+}
@@ -6,8 +6,12 @@
 #define DBSCANClusterer_hpp
 
 #include "Clusterer.hpp"
-#include "dbscan.hpp"  // your existing dbscan header
+#include "PointGrid.hpp"
 
+// DBSCAN over an epsilon wide grid of the points. core points are found and joined
+// band by band of grid rows in parallel, then the seams between bands are joined.
+// a border point goes to the earliest cluster it touches, the one a serial DBSCAN
+// expanding from each unvisited core point in order would have reached it from first
 class DBSCANClusterer : public Clusterer {
 public:
 	float epsilon   = 150.0f;
@@ -22,19 +26,35 @@ public:
 		minPoints = _minPoints;
 	}
 
-	std::vector<std::vector<int>> cluster(const std::vector<point2>& points) override {
-		auto rawClusters = dbscan(points, epsilon, minPoints);
-
-		std::vector<std::vector<int>> result;
-		result.reserve(rawClusters.size());
-		for (auto& cluster : rawClusters) {
-			std::vector<int> converted(cluster.begin(), cluster.end());
-			result.push_back(std::move(converted));
-		}
-		return result;
-	}
+	void cluster(const PointBuffer& points, ClusterList& clusters) override;
 
 	std::string getName() override { return "DBSCAN"; }
+
+private:
+	void markCorePoints(int firstRow, int lastRow);
+	void joinCorePoints(int firstRow, int lastRow);
+	void joinSeam(int row);
+	void joinNextRow(int column, int row);
+	void joinCells(int cell, int neighbor);
+	void findBorderRoots(int firstRow, int lastRow);
+
+	int  findRoot(int i);
+	void join(int a, int b);
+
+	float epsilonSquared;
+
+	// everything below is kept from scan to scan and only grows
+	PointGrid grid;
+	std::vector<int> bandRows;
+
+	// indexed by position in the buffer
+	std::vector<uint8_t> isCore;
+	std::vector<int> parents;
+	std::vector<int> roots;      // a core point's cluster root, a border point's earliest neighbor root, else -1
+
+	std::vector<int> labels;
+	std::vector<int> sizes;
+	std::vector<int> clusterStarts;
 };
 
 #endif /* DBSCANClusterer_hpp */
@@ -4,106 +4,136 @@
 
 #include "EuclideanClusterer.hpp"
 #include <cmath>
-#include <queue>
-
-EuclideanClusterer::CellKey EuclideanClusterer::cellFor(const point2& p, float cellSize) const {
-	int cx = (int)std::floor(p.x / cellSize);
-	int cy = (int)std::floor(p.y / cellSize);
-	return { cx, cy };
-}
+#include <algorithm>
+
+void EuclideanClusterer::cluster(const PointBuffer& points, ClusterList& clusters) {
+	int n = points.numberPoints;
+	clusters.clear();
+	if (n == 0) return;
+
+	toleranceSquared = tolerance * tolerance;
+	grid.build(points, tolerance);
+
+	// connected components, the lowest point index of each is its root. bands of
+	// grid rows are joined in parallel, each only touching the points in its rows,
+	// then the seams between them. the components don't depend on the order pairs
+	// are joined in, so the clusters are the same as on one thread
+	parents.resize(n);
+	for (int i = 0; i < n; i++) parents[i] = i;
+
+	int numberBands = grid.splitRows(getNumberParts(n), bandRows);
+	runParts(numberBands, [this](int b) {
+		joinNeighbors(bandRows[b], bandRows[b + 1]);
+	});
+	for (int b = 1; b < numberBands; b++) {
+		joinSeam(bandRows[b] - 1);
+	}
 
-std::vector<int> EuclideanClusterer::neighborsOf(
-	int idx,
-	const std::vector<point2>& points,
-	const std::unordered_map<CellKey, std::vector<int>, CellKeyHash>& grid,
-	float cellSize) const
-{
-	std::vector<int> result;
-	const point2& p = points[idx];
-	auto [cx, cy] = cellFor(p, cellSize);
-
-	float tolSq = tolerance * tolerance;
-
-	// check the 3x3 neighborhood of cells around this point
-	for (int dx = -1; dx <= 1; dx++) {
-		for (int dy = -1; dy <= 1; dy++) {
-			auto it = grid.find({ cx + dx, cy + dy });
-			if (it == grid.end()) continue;
-
-			for (int neighborIdx : it->second) {
-				if (neighborIdx == idx) continue;
-
-				const point2& q = points[neighborIdx];
-				float diffX = p.x - q.x;
-				float diffY = p.y - q.y;
-				float distSq = diffX * diffX + diffY * diffY;
-
-				if (distSq <= tolSq) {
-					result.push_back(neighborIdx);
-				}
-			}
+	// clusters numbered by their lowest point index, same as flood filling from each
+	// unvisited point in order
+	labels.resize(n);
+	sizes.clear();
+	for (int i = 0; i < n; i++) {
+		int root = findRoot(i);
+		if (root == i) {
+			labels[i] = sizes.size();
+			sizes.push_back(0);
+		} else {
+			labels[i] = labels[root];
 		}
+		sizes[labels[i]]++;
 	}
 
-	return result;
-}
-
-std::vector<std::vector<int>> EuclideanClusterer::cluster(const std::vector<point2>& points) {
-	int n = (int)points.size();
-	if (n == 0) return {};
+	// the clusters big enough to keep, -1 for the rest
+	int numberClusters = sizes.size();
+	int numberIndices = 0;
+	keptClusters.resize(numberClusters);
+	clusterStarts.clear();
+	for (int c = 0; c < numberClusters; c++) {
+		if (sizes[c] < minPoints) {
+			keptClusters[c] = -1;
+			continue;
+		}
 
-	// cell size = tolerance so each point only needs to check its 3x3 neighbor cells
-	float cellSize = tolerance;
+		keptClusters[c] = clusterStarts.size();
+		clusterStarts.push_back(numberIndices);
+		numberIndices += sizes[c];
+		clusters.offsets.push_back(numberIndices);
+	}
 
-	// build spatial hash grid
-	std::unordered_map<CellKey, std::vector<int>, CellKeyHash> grid;
-	grid.reserve(n);
+	// each cluster's indices in ascending order, its moments summed along the way
+	clusters.indices.resize(numberIndices);
+	clusters.moments.resize(clusterStarts.size());
 	for (int i = 0; i < n; i++) {
-		grid[cellFor(points[i], cellSize)].push_back(i);
+		int k = keptClusters[labels[i]];
+		if (k < 0) continue;
+		clusters.indices[clusterStarts[k]++] = i;
+		clusters.moments[k].add(points.x[i], points.y[i]);
 	}
+}
 
-	// flood-fill connected components
-	std::vector<int> labels(n, -1);  // -1 = unvisited
-	int currentLabel = 0;
+void EuclideanClusterer::joinNeighbors(int firstRow, int lastRow) {
+	// the rest of a cell and the neighbors ahead of it, so each pair of cells is
+	// only compared once
+	for (int row = firstRow; row < lastRow; row++) {
+		for (int column = 0; column < grid.numberColumns; column++) {
+			int cell = grid.getCell(column, row);
+			if (grid.cellStarts[cell] == grid.cellStarts[cell + 1]) continue;
 
-	for (int i = 0; i < n; i++) {
-		if (labels[i] != -1) continue;
-
-		// BFS from this seed point
-		std::queue<int> q;
-		q.push(i);
-		labels[i] = currentLabel;
-
-		while (!q.empty()) {
-			int current = q.front();
-			q.pop();
-
-			for (int neighbor : neighborsOf(current, points, grid, cellSize)) {
-				if (labels[neighbor] == -1) {
-					labels[neighbor] = currentLabel;
-					q.push(neighbor);
-				}
+			joinCells(cell, cell);
+			if (column + 1 < grid.numberColumns) joinCells(cell, cell + 1);
+			if (row + 1 >= lastRow) continue;
+
+			for (int neighborColumn = std::max(column - 1, 0); neighborColumn <= std::min(column + 1, grid.numberColumns - 1); neighborColumn++) {
+				joinCells(cell, grid.getCell(neighborColumn, row + 1));
 			}
 		}
-
-		currentLabel++;
 	}
+}
 
-	// group indices by label, filter by minPoints
-	std::vector<std::vector<int>> rawClusters(currentLabel);
-	for (int i = 0; i < n; i++) {
-		if (labels[i] >= 0) {
-			rawClusters[labels[i]].push_back(i);
+void EuclideanClusterer::joinSeam(int row) {
+	for (int column = 0; column < grid.numberColumns; column++) {
+		int cell = grid.getCell(column, row);
+		if (grid.cellStarts[cell] == grid.cellStarts[cell + 1]) continue;
+
+		for (int neighborColumn = std::max(column - 1, 0); neighborColumn <= std::min(column + 1, grid.numberColumns - 1); neighborColumn++) {
+			joinCells(cell, grid.getCell(neighborColumn, row + 1));
 		}
 	}
+}
 
-	std::vector<std::vector<int>> result;
-	result.reserve(rawClusters.size());
-	for (auto& cluster : rawClusters) {
-		if ((int)cluster.size() >= minPoints) {
-			result.push_back(std::move(cluster));
+void EuclideanClusterer::joinCells(int cell, int neighbor) {
+	const std::vector<int>& cellStarts = grid.cellStarts;
+	const std::vector<int>& sortedIndices = grid.sortedIndices;
+	const std::vector<float>& sortedX = grid.sortedX;
+	const std::vector<float>& sortedY = grid.sortedY;
+
+	for (int a = cellStarts[cell]; a < cellStarts[cell + 1]; a++) {
+		float x = sortedX[a];
+		float y = sortedY[a];
+
+		int first = cell == neighbor ? a + 1 : cellStarts[neighbor];
+		for (int b = first; b < cellStarts[neighbor + 1]; b++) {
+			float dx = x - sortedX[b];
+			float dy = y - sortedY[b];
+			if (dx * dx + dy * dy <= toleranceSquared) join(sortedIndices[a], sortedIndices[b]);
 		}
 	}
+}
+
+int EuclideanClusterer::findRoot(int i) {
+	while (parents[i] != i) {
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+void EuclideanClusterer::join(int a, int b) {
+	a = findRoot(a);
+	b = findRoot(b);
+	if (a == b) return;
 
-	return result;
+	if (a < b) parents[b] = a;
+	else parents[a] = b;
 }
@@ -6,7 +6,7 @@
 #define EuclideanClusterer_hpp
 
 #include "Clusterer.hpp"
-#include <unordered_map>
+#include "PointGrid.hpp"
 
 class EuclideanClusterer : public Clusterer {
 public:
@@ -22,28 +22,30 @@ public:
 		minPoints  = _minPoints;
 	}
 
-	std::vector<std::vector<int>> cluster(const std::vector<point2>& points) override;
+	void cluster(const PointBuffer& points, ClusterList& clusters) override;
 
 	std::string getName() override { return "Euclidean"; }
 
 private:
-	// spatial hash helpers
-	using CellKey = std::pair<int, int>;
-
-	struct CellKeyHash {
-		size_t operator()(const CellKey& k) const {
-			// combine two ints into a single hash
-			size_t h1 = std::hash<int>{}(k.first);
-			size_t h2 = std::hash<int>{}(k.second);
-			return h1 ^ (h2 * 2654435761u);
-		}
-	};
-
-	CellKey cellFor(const point2& p, float cellSize) const;
-	std::vector<int> neighborsOf(int idx,
-								 const std::vector<point2>& points,
-								 const std::unordered_map<CellKey, std::vector<int>, CellKeyHash>& grid,
-								 float cellSize) const;
+	void joinNeighbors(int firstRow, int lastRow);
+	void joinSeam(int row);
+	void joinCells(int cell, int neighbor);
+
+	int  findRoot(int i);
+	void join(int a, int b);
+
+	// cells at least the tolerance wide, so each point only checks its 3x3 neighbor cells.
+	// the grid and everything below are kept from scan to scan and only grow
+	PointGrid grid;
+	std::vector<int> bandRows;
+
+	float toleranceSquared;
+
+	std::vector<int> parents;
+	std::vector<int> labels;
+	std::vector<int> sizes;
+	std::vector<int> keptClusters;
+	std::vector<int> clusterStarts;
 };
 
 #endif /* EuclideanClusterer_hpp */
@@ -7,9 +7,12 @@
 
 #include "ofMain.h"
 #include "Blob.hpp"
+#include "PointBuffer.h"
 #include "Clusterer.hpp"
 #include "EuclideanClusterer.hpp"
 #include "DBSCANClusterer.hpp"
+#include "SegmentClusterer.hpp"
+#include "BlobTracker.hpp"
 #include <memory>
 #include <vector>
 #include <string>
@@ -19,10 +22,9 @@ class Meatbags {
 public:
 	Meatbags();
 
-	void update();
+	void update(float deltaTime);
 	void updateBlobs();
 	void getBlobs(std::vector<Blob>& blobs);
-	void setMaxCoordinateSize(int maxCoordinateSize);
 
 	void setClusterer(std::unique_ptr<Clusterer> c);
 	std::string getClustererName();
@@ -30,14 +32,21 @@ public:
 
 	int index;
 
-	std::vector<ofPoint> coordinates;
-	std::vector<int>     intensities;
-	int                  numberCoordinates;
+	// the points inside the filters, filled by SensorManager::getCoordinates
+	PointBuffer points;
+
+	// when the newest scan behind points was taken, in seconds on Sensor::getClockTime()
+	double scanTime;
+
+	// the tracking thread's workers, handed to the clusterer
+	WorkerPool* workerPool;
 
 	ofParameter<float> epsilon           = { "epsilon",        150.0f, 1.0f,  1000.0f };
 	ofParameter<int>   minPoints         = { "min points",     3,      1,     50      };
 	ofParameter<float> blobPersistence   = { "blob persistence", 0.5f, 0.0f,  5.0f   };
-	ofParameter<float> velocitySmoothing = { "vel smoothing",  0.2f,   0.01f, 1.0f   };
+	ofParameter<float> matchDistance     = { "match distance", 1.0f,   0.05f, 5.0f   };   // m
+	ofParameter<float> processNoise      = { "process noise",  2.0f,   0.01f, 20.0f  };   // m/s²
+	ofParameter<float> measurementNoise  = { "measurement noise", 0.05f, 0.001f, 1.0f }; // m
 
 	std::vector<Blob> oldBlobs;
 
@@ -46,14 +55,20 @@ private:
 	void  matchBlobs();
 	void  addBlobs();
 	void  renewBlobs();
-	int   findFreeBlobIndex();
-	float compareBlobs(Blob newBlob, Blob oldBlob);
 
 	void setBlobPersistence(float& _blobPersistence);
 
 	std::vector<Blob>          newBlobs;
 	std::unique_ptr<Clusterer> clusterer;
+	ClusterList                clusters;
+	BlobTracker                tracker;
+	std::vector<int>           assignments;
 	double                     lastFrameTime;
+	double                     lastScanTime;
+
+	// longer gaps between scans, or going back in time, are a seek or a stall
+	// rather than movement, so the tracks aren't moved across them
+	static constexpr double MAX_PREDICTION_TIME = 1.0;
 };
 
 #endif /* Meatbags_hpp */
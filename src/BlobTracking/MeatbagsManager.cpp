@@ -5,25 +5,14 @@
 #include "MeatbagsManager.hpp"
 #include "DBSCANClusterer.hpp"
 #include "EuclideanClusterer.hpp"
+#include "SegmentClusterer.hpp"
 
 MeatbagsManager::MeatbagsManager() {
 }
 
-void MeatbagsManager::setMaxCoordinateSize(int maxCoordinateSize) {
+void MeatbagsManager::update(float deltaTime) {
 	for (auto& entry : meatbagsEntries) {
-		entry.meatbags->setMaxCoordinateSize(maxCoordinateSize);
-	}
-}
-
-void MeatbagsManager::update() {
-	for (auto& entry : meatbagsEntries) {
-		entry.meatbags->update();
-	}
-}
-
-void MeatbagsManager::updateBlobs() {
-	for (auto& entry : meatbagsEntries) {
-		entry.meatbags->updateBlobs();
+		entry.meatbags->update(deltaTime);
 	}
 }
 
@@ -58,7 +47,9 @@ void MeatbagsManager::addMeatbags() {
 	meatbags->epsilon.set("epsilon",            100,  1,    1000);
 	meatbags->minPoints.set("min points",       10,   1,    150);
 	meatbags->blobPersistence.set("blob persistence", 0.25f, 0.0f, 3.0f);
-	meatbags->velocitySmoothing.set("vel smoothing",  0.2f,  0.01f, 1.0f);
+	meatbags->matchDistance.set("match distance",     1.0f,  0.05f, 5.0f);
+	meatbags->processNoise.set("process noise",       2.0f,  0.01f, 20.0f);
+	meatbags->measurementNoise.set("measurement noise", 0.05f, 0.001f, 1.0f);
 
 	meatbagsEntries.push_back({ std::move(meatbags) });
 }
@@ -80,11 +71,14 @@ void MeatbagsManager::loadMeatbags(int numberMeatbags, ofJson& config) {
 		if (m.contains("epsilon"))            mb->epsilon           = m["epsilon"].get<float>();
 		if (m.contains("min_points"))         mb->minPoints         = m["min_points"].get<int>();
 		if (m.contains("blob_persistence"))   mb->blobPersistence   = m["blob_persistence"].get<float>();
-		if (m.contains("velocity_smoothing")) mb->velocitySmoothing = m["velocity_smoothing"].get<float>();
+		if (m.contains("match_distance"))     mb->matchDistance     = m["match_distance"].get<float>();
+		if (m.contains("process_noise"))      mb->processNoise      = m["process_noise"].get<float>();
+		if (m.contains("measurement_noise"))  mb->measurementNoise  = m["measurement_noise"].get<float>();
 		if (m.contains("clusterer")) {
 			std::string type = m["clusterer"].get<std::string>();
-			if (type == "Euclidean") mb->setClusterer(std::make_unique<EuclideanClusterer>());
-			else                     mb->setClusterer(std::make_unique<DBSCANClusterer>());
+			if (type == "Euclidean")    mb->setClusterer(std::make_unique<EuclideanClusterer>());
+			else if (type == "Segment") mb->setClusterer(std::make_unique<SegmentClusterer>());
+			else                        mb->setClusterer(std::make_unique<DBSCANClusterer>());
 		}
 	}
 }
@@ -106,7 +100,9 @@ void MeatbagsManager::saveTo(ofJson& config) {
 		config[key]["epsilon"]            = mb->epsilon.get();
 		config[key]["min_points"]         = mb->minPoints.get();
 		config[key]["blob_persistence"]   = mb->blobPersistence.get();
-		config[key]["velocity_smoothing"] = mb->velocitySmoothing.get();
+		config[key]["match_distance"]     = mb->matchDistance.get();
+		config[key]["process_noise"]      = mb->processNoise.get();
+		config[key]["measurement_noise"]  = mb->measurementNoise.get();
 		config[key]["clusterer"]          = mb->getClustererName();
 	}
 }
@@ -16,10 +16,8 @@ class MeatbagsManager {
 public:
 	MeatbagsManager();
 
-	void update();
-	void updateBlobs();
+	void update(float deltaTime);
 	void getBlobs(std::vector<Blob>& blobs);
-	void setMaxCoordinateSize(int maxCoordinateSize);
 	void addMeatbags();
 	void removeMeatbag();
 	std::vector<Meatbags*> getMeatbags();
@@ -0,0 +1,75 @@
+//
+//  PointBuffer.h
+//  meatbags
+//
+
+#pragma once
+#include "ofMain.h"
+
+// points as separate arrays so each stage streams only the fields it reads,
+// coordinates are in mm and sensorIndex is the sensor's position in SensorManager.
+// each sensor's points are together and in the order its steps were measured
+struct PointBuffer {
+    enum Flags : uint8_t {
+        InFilter = 1
+    };
+
+    // where each sensor is and the angle between its steps, indexed by sensorIndex
+    struct SensorOrigin {
+        float x = 0;
+        float y = 0;
+        float stepAngle = 0;
+    };
+
+    vector<float>   x;
+    vector<float>   y;
+    vector<uint8_t> sensorIndex;
+    vector<uint8_t> flags;
+    vector<SensorOrigin> sensors;
+    int numberPoints = 0;
+    int numberOverflowed = 0;   // points that didn't fit since the last clear
+
+    // the arrays are reused from frame to frame. growth is by at least half again so
+    // sensors coming up one at a time don't reallocate each time, and memory is
+    // only given back once less than a quarter of it is needed
+    void setCapacity(int required) {
+        int current = x.size();
+        int capacity = current;
+        if (required > current) capacity = std::max(required, current + current / 2);
+        else if (required < current / 4) capacity = required;
+        if (capacity == current) return;
+
+        x.resize(capacity);
+        y.resize(capacity);
+        sensorIndex.resize(capacity);
+        flags.resize(capacity);
+
+        if (capacity < current) {
+            x.shrink_to_fit();
+            y.shrink_to_fit();
+            sensorIndex.shrink_to_fit();
+            flags.shrink_to_fit();
+        }
+    }
+
+    int capacity() const { return x.size(); }
+
+    void clear() {
+        numberPoints = 0;
+        numberOverflowed = 0;
+    }
+
+    // a full buffer counts the point instead of writing past the end
+    inline void push(float _x, float _y, uint8_t _sensorIndex, uint8_t _flags) {
+        if (numberPoints == (int)x.size()) {
+            numberOverflowed++;
+            return;
+        }
+
+        x[numberPoints] = _x;
+        y[numberPoints] = _y;
+        sensorIndex[numberPoints] = _sensorIndex;
+        flags[numberPoints] = _flags;
+        numberPoints++;
+    }
+};
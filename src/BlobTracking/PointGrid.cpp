@@ -0,0 +1,81 @@
+//
+//  PointGrid.cpp
+//  meatbags
+
+#include "PointGrid.hpp"
+
+PointGrid::PointGrid() {
+	numberColumns = 0;
+	numberRows = 0;
+	cellSize = 0;
+	left = 0;
+	top = 0;
+}
+
+int PointGrid::splitRows(int numberBands, std::vector<int>& bandRows) const {
+	numberBands = std::max(std::min(numberBands, numberRows), 1);
+	bandRows.resize(numberBands + 1);
+	for (int b = 0; b <= numberBands; b++) {
+		bandRows[b] = (int64_t)numberRows * b / numberBands;
+	}
+	return numberBands;
+}
+
+void PointGrid::build(const PointBuffer& points, float minimumCellSize) {
+	int n = points.numberPoints;
+	const float* pointsX = points.x.data();
+	const float* pointsY = points.y.data();
+
+	if (n == 0) {
+		numberColumns = 0;
+		numberRows = 0;
+		cellStarts.assign(1, 0);
+		return;
+	}
+
+	const auto rangeX = std::minmax_element(pointsX, pointsX + n);
+	const auto rangeY = std::minmax_element(pointsY, pointsY + n);
+	left = *rangeX.first;
+	top = *rangeY.first;
+
+	// mostly empty cells cost more to walk than the extra comparisons in bigger ones
+	int64_t maximumCells = std::min(MAX_CELLS, std::max(CELLS_PER_POINT * n, 4096));
+
+	cellSize = std::max(minimumCellSize, 1e-3f);
+	do {
+		numberColumns = (int)((*rangeX.second - left) / cellSize) + 1;
+		numberRows = (int)((*rangeY.second - top) / cellSize) + 1;
+		if ((int64_t)numberColumns * numberRows <= maximumCells) break;
+		cellSize *= 2.0f;
+	} while (true);
+	float inverseCellSize = 1.0f / cellSize;
+
+	int numberCells = numberColumns * numberRows;
+	cellStarts.assign(numberCells + 1, 0);
+	pointCells.resize(n);
+	for (int i = 0; i < n; i++) {
+		int column = std::min((int)((pointsX[i] - left) * inverseCellSize), numberColumns - 1);
+		int row = std::min((int)((pointsY[i] - top) * inverseCellSize), numberRows - 1);
+		pointCells[i] = getCell(column, row);
+		cellStarts[pointCells[i] + 1]++;
+	}
+	for (int c = 0; c < numberCells; c++) {
+		cellStarts[c + 1] += cellStarts[c];
+	}
+
+	sortedIndices.resize(n);
+	sortedX.resize(n);
+	sortedY.resize(n);
+	for (int i = 0; i < n; i++) {
+		int s = cellStarts[pointCells[i]]++;
+		sortedIndices[s] = i;
+		sortedX[s] = pointsX[i];
+		sortedY[s] = pointsY[i];
+	}
+
+	// the fill moved every start to where the next cell begins
+	for (int c = numberCells; c > 0; c--) {
+		cellStarts[c] = cellStarts[c - 1];
+	}
+	cellStarts[0] = 0;
+}
@@ -0,0 +1,44 @@
+//
+//  PointGrid.hpp
+//  meatbags
+
+#ifndef PointGrid_hpp
+#define PointGrid_hpp
+
+#include "ofMain.h"
+#include "PointBuffer.h"
+
+// points counting sorted into a dense grid over their bounds. with cells at least
+// as wide as a search radius, every point within it is in the 3x3 cells around.
+// cell c holds sortedX[cellStarts[c]] up to sortedX[cellStarts[c + 1]], in the
+// order the points are in the buffer. everything is kept from scan to scan and
+// only grows, so building it doesn't allocate once the busiest scan has been seen
+class PointGrid {
+public:
+	PointGrid();
+
+	void build(const PointBuffer& points, float minimumCellSize);
+
+	int getCell(int column, int row) const { return row * numberColumns + column; }
+
+	// whole rows shared out as evenly as possible, band b is rows bandRows[b] up to
+	// bandRows[b + 1]. returns the number of bands, fewer when there are few rows
+	int splitRows(int numberBands, std::vector<int>& bandRows) const;
+
+	int numberColumns, numberRows;
+	float cellSize;
+
+	std::vector<int>   cellStarts;
+	std::vector<int>   sortedIndices;
+	std::vector<float> sortedX, sortedY;
+
+private:
+	std::vector<int> pointCells;
+	float left, top;
+
+	// larger cells are used when the radius is tiny next to the spread of the points
+	static const int MAX_CELLS = 1 << 20;
+	static const int CELLS_PER_POINT = 16;
+};
+
+#endif /* PointGrid_hpp */
@@ -0,0 +1,184 @@
+//
+//  SegmentClusterer.cpp
+//  meatbags
+
+#include "SegmentClusterer.hpp"
+#include <cmath>
+#include <algorithm>
+
+void SegmentClusterer::cluster(const PointBuffer& points, ClusterList& clusters) {
+	int n = points.numberPoints;
+	segments.clear();
+	clusters.clear();
+	if (n == 0) return;
+
+	// how far apart returns on a surface at the incidence angle are, per mm of range,
+	// for each sensor's angle between steps
+	rangeFactors.assign(points.sensors.size(), 0.0f);
+	for (int s = 0; s < points.sensors.size(); s++) {
+		float stepAngle = points.sensors[s].stepAngle;
+		if (stepAngle <= 0.0f) continue;
+		if (stepAngle >= incidenceAngle) rangeFactors[s] = std::numeric_limits<float>::max();
+		else rangeFactors[s] = sin(stepAngle) / sin(incidenceAngle - stepAngle);
+	}
+
+	// points arrive sensor by sensor in step order, so a break is wherever the
+	// sensor changes or a return lands too far from the one before it
+	int first = 0;
+	for (int i = 1; i <= n; i++) {
+		bool isBreak = i == n || points.sensorIndex[i] != points.sensorIndex[first];
+		if (!isBreak) {
+			float dx = points.x[i] - points.x[i - 1];
+			float dy = points.y[i] - points.y[i - 1];
+			float breakDistance = getBreakDistance(points, i - 1);
+			isBreak = dx * dx + dy * dy > breakDistance * breakDistance;
+		}
+
+		if (isBreak) {
+			addSegment(points, first, i - 1);
+			first = i;
+		}
+	}
+
+	int numberSegments = segments.size();
+	parents.resize(numberSegments);
+	for (int i = 0; i < numberSegments; i++) parents[i] = i;
+
+	joinWrappedScans(points);
+	joinAcrossSensors();
+
+	// clusters numbered in the order their first segment was scanned
+	labels.assign(numberSegments, -1);
+	sizes.clear();
+	for (int i = 0; i < numberSegments; i++) {
+		int root = findRoot(i);
+		if (labels[root] == -1) {
+			labels[root] = sizes.size();
+			sizes.push_back(0);
+		}
+		sizes[labels[root]] += segments[i].last - segments[i].first + 1;
+	}
+
+	// segments grouped by cluster with a counting sort, in scan order within each
+	int numberClusters = sizes.size();
+	clusterStarts.assign(numberClusters + 1, 0);
+	for (int i = 0; i < numberSegments; i++) {
+		labels[i] = labels[findRoot(i)];
+		clusterStarts[labels[i] + 1]++;
+	}
+	for (int c = 0; c < numberClusters; c++) {
+		clusterStarts[c + 1] += clusterStarts[c];
+	}
+
+	order.resize(numberSegments);
+	for (int i = 0; i < numberSegments; i++) {
+		order[clusterStarts[labels[i]]++] = i;
+	}
+
+	// clusterStarts[c] is now where cluster c ends in order
+	int o = 0;
+	for (int c = 0; c < numberClusters; c++) {
+		int end = clusterStarts[c];
+		if (sizes[c] >= minPoints) {
+			ClusterMoments moments;
+			for (; o < end; o++) {
+				const Segment& segment = segments[order[o]];
+				for (int j = segment.first; j <= segment.last; j++) {
+					clusters.indices.push_back(j);
+					moments.add(points.x[j], points.y[j]);
+				}
+			}
+			clusters.closeCluster();
+			clusters.moments.push_back(moments);
+		}
+		o = end;
+	}
+}
+
+float SegmentClusterer::getBreakDistance(const PointBuffer& points, int i) const {
+	int s = points.sensorIndex[i];
+	if (s >= rangeFactors.size()) return epsilon;
+
+	float dx = points.x[i] - points.sensors[s].x;
+	float dy = points.y[i] - points.sensors[s].y;
+	float range = sqrt(dx * dx + dy * dy);
+
+	return std::max(epsilon, range * rangeFactors[s]);
+}
+
+void SegmentClusterer::addSegment(const PointBuffer& points, int first, int last) {
+	Segment segment;
+	segment.first = first;
+	segment.last = last;
+	segment.sensorIndex = points.sensorIndex[first];
+
+	const auto rangeX = std::minmax_element(points.x.begin() + first, points.x.begin() + last + 1);
+	segment.left = *rangeX.first;
+	segment.right = *rangeX.second;
+
+	const auto rangeY = std::minmax_element(points.y.begin() + first, points.y.begin() + last + 1);
+	segment.top = *rangeY.first;
+	segment.bottom = *rangeY.second;
+
+	segments.push_back(segment);
+}
+
+void SegmentClusterer::joinWrappedScans(const PointBuffer& points) {
+	// a sensor that sees all the way around ends its scan where it began
+	int firstOfSensor = 0;
+	for (int i = 1; i <= segments.size(); i++) {
+		if (i < segments.size() && segments[i].sensorIndex == segments[firstOfSensor].sensorIndex) continue;
+
+		int lastOfSensor = i - 1;
+		if (lastOfSensor != firstOfSensor) {
+			int a = segments[firstOfSensor].first;
+			int b = segments[lastOfSensor].last;
+			float dx = points.x[a] - points.x[b];
+			float dy = points.y[a] - points.y[b];
+			float breakDistance = getBreakDistance(points, b);
+			if (dx * dx + dy * dy <= breakDistance * breakDistance) join(firstOfSensor, lastOfSensor);
+		}
+
+		firstOfSensor = i;
+	}
+}
+
+void SegmentClusterer::joinAcrossSensors() {
+	// sweep along x so only segments whose bounds could be close are compared
+	order.resize(segments.size());
+	for (int i = 0; i < order.size(); i++) order[i] = i;
+	std::sort(order.begin(), order.end(), [this](int a, int b) {
+		return segments[a].left < segments[b].left;
+	});
+
+	for (int i = 0; i < order.size(); i++) {
+		const Segment& a = segments[order[i]];
+
+		for (int j = i + 1; j < order.size(); j++) {
+			const Segment& b = segments[order[j]];
+			if (b.left > a.right + epsilon) break;
+			if (b.sensorIndex == a.sensorIndex) continue;
+			if (b.top > a.bottom + epsilon || a.top > b.bottom + epsilon) continue;
+
+			join(order[i], order[j]);
+		}
+	}
+}
+
+int SegmentClusterer::findRoot(int segment) {
+	while (parents[segment] != segment) {
+		parents[segment] = parents[parents[segment]];
+		segment = parents[segment];
+	}
+	return segment;
+}
+
+void SegmentClusterer::join(int a, int b) {
+	a = findRoot(a);
+	b = findRoot(b);
+	if (a == b) return;
+
+	// the earlier segment stays the root
+	if (a < b) parents[b] = a;
+	else parents[a] = b;
+}
@@ -0,0 +1,61 @@
+//
+//  SegmentClusterer.hpp
+//  meatbags
+
+#ifndef SegmentClusterer_hpp
+#define SegmentClusterer_hpp
+
+#include "Clusterer.hpp"
+
+// splits each sensor's scan wherever neighbouring returns jump apart, in one pass
+// over the points in the order they were measured. the break distance grows with
+// range, since returns on the same surface spread out the farther it is. segments
+// from different sensors are then joined when their bounds come within epsilon
+class SegmentClusterer : public Clusterer {
+public:
+	float epsilon   = 150.0f;  // shortest break distance between neighbouring returns (mm)
+	int   minPoints = 3;       // minimum points to form a cluster
+
+	// surfaces seen more edge on than this are split between every pair of returns
+	float incidenceAngle = 10.0f * DEG_TO_RAD;
+
+	SegmentClusterer() = default;
+	SegmentClusterer(float epsilon, int minPoints)
+		: epsilon(epsilon), minPoints(minPoints) {}
+
+	void setParameters(float _epsilon, int _minPoints) override {
+		epsilon   = _epsilon;
+		minPoints = _minPoints;
+	}
+
+	void cluster(const PointBuffer& points, ClusterList& clusters) override;
+
+	std::string getName() override { return "Segment"; }
+
+private:
+	// a run of consecutive points from one sensor
+	struct Segment {
+		int first, last;
+		int sensorIndex;
+		float left, top, right, bottom;
+	};
+
+	float getBreakDistance(const PointBuffer& points, int i) const;
+	void  addSegment(const PointBuffer& points, int first, int last);
+	void  joinWrappedScans(const PointBuffer& points);
+	void  joinAcrossSensors();
+
+	int  findRoot(int segment);
+	void join(int a, int b);
+
+	// reused from scan to scan
+	std::vector<Segment> segments;
+	std::vector<int> parents;
+	std::vector<int> order;
+	std::vector<int> labels;
+	std::vector<int> sizes;
+	std::vector<int> clusterStarts;
+	std::vector<float> rangeFactors;
+};
+
+#endif /* SegmentClusterer_hpp */
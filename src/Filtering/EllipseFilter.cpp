@@ -6,21 +6,26 @@
 #include "EllipseFilter.hpp"
 
 EllipseFilter::EllipseFilter() {
+    xRadius = 0;
+    yRadius = 0;
+    rotation = 0;
+    rotationCos = 1;
+    rotationSin = 0;
 }
 
 void EllipseFilter::updateNormalization() {
 }
 
-ofPoint EllipseFilter::getPointOnEllipse(int index) {
-    ofPoint center;
-    for (auto& p : draggablePoints) center += p;
+void EllipseFilter::updateShape() {
+    center = ofPoint::zero();
+    for (auto& anchorPoint : anchorPoints) center += ofPoint(anchorPoint.get());
     center /= 4.0;
 
     float maxDist = 0;
     int i1 = 0, i2 = 0;
     for (int i = 0; i < 4; ++i) {
         for (int j = i + 1; j < 4; ++j) {
-            float d = draggablePoints[i].distance(draggablePoints[j]);
+            float d = anchorPoints[i]->distance(anchorPoints[j]);
             if (d > maxDist) {
                 maxDist = d;
                 i1 = i;
@@ -29,42 +34,38 @@ ofPoint EllipseFilter::getPointOnEllipse(int index) {
         }
     }
 
-    ofPoint major1 = draggablePoints[i1];
-    ofPoint major2 = draggablePoints[i2];
+    ofPoint major1 = ofPoint(anchorPoints[i1].get());
+    ofPoint major2 = ofPoint(anchorPoints[i2].get());
 
     std::vector<int> remaining;
     for (int i = 0; i < 4; ++i) {
         if (i != i1 && i != i2) remaining.push_back(i);
     }
-    ofPoint minor1 = draggablePoints[remaining[0]];
-    ofPoint minor2 = draggablePoints[remaining[1]];
-    
-    float theta = ofMap(index, 0, ellipseResolution, 0, TWO_PI);
-    
+    ofPoint minor1 = ofPoint(anchorPoints[remaining[0]].get());
+    ofPoint minor2 = ofPoint(anchorPoints[remaining[1]].get());
+
     ofPoint majorVec = major2 - major1;
-    
-    float rotation = atan2(majorVec.y, majorVec.x);
-    float a = major1.distance(major2) * 0.5;
-    float b = minor1.distance(minor2) * 0.5;
+
+    rotation = atan2(majorVec.y, majorVec.x);
+    rotationCos = cos(rotation);
+    rotationSin = sin(rotation);
+    xRadius = major1.distance(major2) * 0.5;
+    yRadius = minor1.distance(minor2) * 0.5;
+}
+
+ofPoint EllipseFilter::getPointOnEllipse(int index) {
+    float theta = ofMap(index, 0, ellipseResolution, 0, TWO_PI);
 
     float ct = cos(theta);
     float st = sin(theta);
-    float cp = cos(rotation);
-    float sp = sin(rotation);
-    
-    float x = center.x + a * ct * cp - b * st * sp;
-    float y = center.y + a * ct * sp + b * st * cp;
+
+    float x = center.x + xRadius * ct * rotationCos - yRadius * st * rotationSin;
+    float y = center.y + xRadius * ct * rotationSin + yRadius * st * rotationCos;
 
     return ofPoint(x, y);
 }
 
 void EllipseFilter::update() {
-    polyline.clear();
-    for (int i = 0; i < ellipseResolution; i++) {
-        polyline.addVertex(getPointOnEllipse(i));
-    }
-    polyline.close();
-    
     Filter::update();
 
     for (int i = 0; i < draggablePoints.size(); i++) {
@@ -72,6 +73,29 @@ void EllipseFilter::update() {
             updateDraggablePoints(i);
         }
     }
+
+    // the outline is only for drawing and the filter grid, it is rebuilt when the anchors move
+    if (!updateGeometryVersion()) return;
+
+    updateShape();
+
+    polyline.clear();
+    for (int i = 0; i < ellipseResolution; i++) {
+        polyline.addVertex(getPointOnEllipse(i));
+    }
+    polyline.close();
+}
+
+bool EllipseFilter::checkInside(float x, float y) {
+    // the ellipse itself rather than its outline, in the frame of its axes
+    float dx = x - center.x;
+    float dy = y - center.y;
+    float u = dx * rotationCos + dy * rotationSin;
+    float v = dy * rotationCos - dx * rotationSin;
+
+    float a2 = xRadius * xRadius;
+    float b2 = yRadius * yRadius;
+    return u * u * b2 + v * v * a2 <= a2 * b2;
 }
 
 void EllipseFilter::reset() {
@@ -106,95 +130,29 @@ void EllipseFilter::updateDraggablePoints(int anchorIndex) {
 }
 
 ofPoint EllipseFilter::normalizeCoordinate(float x, float y) {
-    ofPoint inputPoint(x, y);
-    
-    ofPoint center;
-    for (auto& p : draggablePoints) center += p;
-    center /= 4.0;
-    
-    float maxDist = 0;
-    int i1 = 0, i2 = 0;
-    for (int i = 0; i < 4; ++i) {
-        for (int j = i + 1; j < 4; ++j) {
-            float d = draggablePoints[i].distance(draggablePoints[j]);
-            if (d > maxDist) {
-                maxDist = d;
-                i1 = i;
-                i2 = j;
-            }
-        }
-    }
-    
-    ofPoint major1 = draggablePoints[i1];
-    ofPoint major2 = draggablePoints[i2];
-    
-    std::vector<int> remaining;
-    for (int i = 0; i < 4; ++i) {
-        if (i != i1 && i != i2) remaining.push_back(i);
-    }
-    ofPoint minor1 = draggablePoints[remaining[0]];
-    ofPoint minor2 = draggablePoints[remaining[1]];
-    
-    ofPoint majorVec = major2 - major1;
-    float rotation = atan2(majorVec.y, majorVec.x);
-    float a = major1.distance(major2) * 0.5;
-    float b = minor1.distance(minor2) * 0.5;
-    
-    ofPoint translatedPoint = inputPoint - center;
-    
-    float cp = cos(-rotation);
-    float sp = sin(-rotation);
+    ofPoint translatedPoint = ofPoint(x, y) - center;
+
+    float cp = rotationCos;
+    float sp = -rotationSin;
     float rotatedX = translatedPoint.x * cp - translatedPoint.y * sp;
     float rotatedY = translatedPoint.x * sp + translatedPoint.y * cp;
-    
-    ofPoint normalizedCoordinate(-rotatedX / a, rotatedY / b);
-    
+
+    ofPoint normalizedCoordinate(-rotatedX / xRadius, rotatedY / yRadius);
+
     return normalizedCoordinate;
 }
 
 ofPoint EllipseFilter::normalizeSize(float x, float y, float width, float height) {
-    ofPoint center;
-    for (auto& p : draggablePoints) center += p;
-    center /= 4.0;
-
-    float maxDist = 0;
-    int i1 = 0, i2 = 0;
-    for (int i = 0; i < 4; ++i) {
-        for (int j = i + 1; j < 4; ++j) {
-            float d = draggablePoints[i].distance(draggablePoints[j]);
-            if (d > maxDist) {
-                maxDist = d;
-                i1 = i;
-                i2 = j;
-            }
-        }
-    }
-
-    ofPoint major1 = draggablePoints[i1];
-    ofPoint major2 = draggablePoints[i2];
-
-    std::vector<int> remaining;
-    for (int i = 0; i < 4; ++i) {
-        if (i != i1 && i != i2) remaining.push_back(i);
-    }
-    ofPoint minor1 = draggablePoints[remaining[0]];
-    ofPoint minor2 = draggablePoints[remaining[1]];
-
-    ofPoint majorVec = major2 - major1;
-    float rotation = atan2(majorVec.y, majorVec.x);
-    float a = major1.distance(major2) * 0.5;
-    float b = minor1.distance(minor2) * 0.5;
-
     // Create width and height vectors
     ofPoint widthVec(width, 0);
     ofPoint heightVec(0, height);
 
     // Apply inverse rotation to align with ellipse coordinate system
-    float cp = cos(-rotation);
-    float sp = sin(-rotation);
+    float cp = rotationCos;
+    float sp = -rotationSin;
 
-    float normalizedWidth = (widthVec.x * cp - widthVec.y * sp) / a;
-    float normalizedHeight = (heightVec.x * sp + heightVec.y * cp) / b;
+    float normalizedWidth = (widthVec.x * cp - widthVec.y * sp) / xRadius;
+    float normalizedHeight = (heightVec.x * sp + heightVec.y * cp) / yRadius;
 
     return ofPoint(abs(normalizedWidth), abs(normalizedHeight));
 }
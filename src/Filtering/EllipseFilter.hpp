@@ -19,11 +19,16 @@ public:
     virtual void reset() override;
     virtual ofPoint normalizeCoordinate(float x, float y) override;
     virtual ofPoint normalizeSize(float x, float y, float width, float height) override;
+    virtual bool checkInside(float x, float y) override;
 
     void updateDraggablePoints(int anchorIndex);
 
+    // center, radii and rotation from the anchor points, cached until they move
+    void updateShape();
     ofPoint getPointOnEllipse(int index);
+    ofPoint center;
     float xRadius, yRadius, rotation;
+    float rotationCos, rotationSin;
     int ellipseResolution = 200;
 };
 
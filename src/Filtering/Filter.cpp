@@ -4,8 +4,11 @@
 
 #include "Filter.hpp"
 
+unsigned int Filter::nextGeometryVersion = 1;
+
 Filter::Filter() {
 	isActive = true;
+	geometryVersion = 0;
 	
 	draggablePoints.resize(numberAnchorPoints);
 	anchorPoints.resize(numberAnchorPoints);
@@ -63,6 +66,21 @@ void Filter::drawShape() {
 	ofEndShape();
 }
 
+bool Filter::updateGeometryVersion() {
+	bool hasChanged = geometryAnchorPoints.size() != anchorPoints.size();
+	for (int i = 0; i < anchorPoints.size() && !hasChanged; i++) {
+		hasChanged = geometryAnchorPoints[i] != anchorPoints[i].get();
+	}
+	if (!hasChanged) return false;
+
+	geometryAnchorPoints.resize(anchorPoints.size());
+	for (int i = 0; i < anchorPoints.size(); i++) {
+		geometryAnchorPoints[i] = anchorPoints[i];
+	}
+	geometryVersion = nextGeometryVersion++;
+	return true;
+}
+
 void Filter::updateNormalization() {
 	// will be overridden
 }
@@ -77,7 +95,7 @@ void Filter::checkBlobs(vector<Blob>& blobs) {
 		float x = blob.centroid.x * 0.001;
 		float y = blob.centroid.y * 0.001;
 		
-		if (polyline.inside(x, y)) {
+		if (checkInside(x, y)) {
 			filterBlobs.push_back(blob);
 			
 			isBlobInside = true;
@@ -64,6 +64,17 @@ public:
 
 	ofPoint translation;
 	Space   space;
+
+	// changes whenever the anchor points move and never repeats across filters, so
+	// anything cached against the outline only has to compare versions
+	unsigned int geometryVersion;
+
+protected:
+	// true and a new version when the anchor points moved since the last call
+	bool updateGeometryVersion();
+
+	vector<ofVec2f> geometryAnchorPoints;
+	static unsigned int nextGeometryVersion;
 };
 
 #endif /* Filter_hpp */
@@ -0,0 +1,217 @@
+//
+//  FilterGrid.cpp
+//  meatbags
+
+#include "FilterGrid.hpp"
+
+FilterGrid::FilterGrid() {
+	left = 0;
+	top = 0;
+	resolution = 0;
+	cellSize = 0.01;
+	inverseCellSize = 100.0;
+	numberColumns = 0;
+	numberRows = 0;
+	numberBoundaryCells = 0;
+}
+
+void FilterGrid::build(const vector<Filter*>& filters, float _resolution) {
+	resolution = _resolution;
+
+	float right = -std::numeric_limits<float>::max();
+	float bottom = -std::numeric_limits<float>::max();
+	left = std::numeric_limits<float>::max();
+	top = std::numeric_limits<float>::max();
+
+	for (const auto& filter : filters) {
+		if (filter->polyline.size() < 3) continue;
+
+		for (const auto& vertex : filter->polyline.getVertices()) {
+			left = std::min(left, vertex.x);
+			top = std::min(top, vertex.y);
+			right = std::max(right, vertex.x);
+			bottom = std::max(bottom, vertex.y);
+		}
+	}
+
+	numberBoundaryCells = 0;
+	if (right < left) {
+		numberColumns = 0;
+		numberRows = 0;
+		cells.clear();
+		return;
+	}
+
+	// a cell of margin so every outline is well inside the grid
+	cellSize = resolution;
+	do {
+		numberColumns = (int)ceil((right - left) / cellSize) + 2;
+		numberRows = (int)ceil((bottom - top) / cellSize) + 2;
+		if ((size_t)numberColumns * numberRows <= MAX_CELLS) break;
+		cellSize *= 2.0;
+	} while (true);
+
+	if (cellSize != resolution) {
+		ofLogNotice("FilterGrid") << "Filters span " << right - left << " x " << bottom - top << " m, using "
+			<< cellSize * 100.0 << " cm cells";
+	}
+
+	left -= cellSize;
+	top -= cellSize;
+	inverseCellSize = 1.0 / cellSize;
+
+	cells.assign((size_t)numberColumns * numberRows, 0);
+	isEdgeCell.assign(cells.size(), 0);
+
+	for (const auto& filter : filters) {
+		if (filter->polyline.size() < 3) continue;
+
+		// EllipseFilter::checkInside tests the ellipse, not the polygon drawn for it
+		auto* ellipse = dynamic_cast<EllipseFilter*>(filter);
+		if (ellipse) rasterizeEllipse(*ellipse, filter->isMask);
+		else rasterize(filter->polyline, filter->isMask);
+	}
+
+	// same precedence as checking the filters one by one, a mask anywhere wins
+	for (auto& cell : cells) {
+		if (cell & MaskInside) cell = Mask;
+		else if (cell & MaskBoundary) cell = Boundary;
+		else if (cell & IncludeInside) cell = Include;
+		else if (cell & IncludeBoundary) cell = Boundary;
+		else cell = Empty;
+
+		if (cell == Boundary) numberBoundaryCells++;
+	}
+}
+
+void FilterGrid::rasterize(const ofPolyline& polyline, bool isMask) {
+	const auto& vertices = polyline.getVertices();
+	int numberVertices = vertices.size();
+
+	uint8_t inside = isMask ? MaskInside : IncludeInside;
+	uint8_t boundary = isMask ? MaskBoundary : IncludeBoundary;
+
+	float minY = std::numeric_limits<float>::max();
+	float maxY = -std::numeric_limits<float>::max();
+	float minX = std::numeric_limits<float>::max();
+	float maxX = -std::numeric_limits<float>::max();
+	for (const auto& vertex : vertices) {
+		minX = std::min(minX, vertex.x);
+		maxX = std::max(maxX, vertex.x);
+		minY = std::min(minY, vertex.y);
+		maxY = std::max(maxY, vertex.y);
+	}
+
+	int firstRow = ofClamp((int)floor((minY - top) * inverseCellSize), 0, numberRows - 1);
+	int lastRow = ofClamp((int)floor((maxY - top) * inverseCellSize), 0, numberRows - 1);
+	int firstColumn = ofClamp((int)floor((minX - left) * inverseCellSize), 0, numberColumns - 1);
+	int lastColumn = ofClamp((int)floor((maxX - left) * inverseCellSize), 0, numberColumns - 1);
+
+	for (int j = 0, k = numberVertices - 1; j < numberVertices; k = j++) {
+		markEdge(vertices[k].x, vertices[k].y, vertices[j].x, vertices[j].y, boundary);
+	}
+
+	// cells no edge passes through are entirely on one side of the outline, so
+	// their centers decide them, with the same even-odd rule as ofPolyline::inside
+	for (int row = firstRow; row <= lastRow; row++) {
+		float y = top + (row + 0.5f) * cellSize;
+
+		crossings.clear();
+		for (int j = 0, k = numberVertices - 1; j < numberVertices; k = j++) {
+			const auto& a = vertices[k];
+			const auto& b = vertices[j];
+			if ((a.y > y) == (b.y > y)) continue;
+			crossings.push_back(a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y));
+		}
+		std::sort(crossings.begin(), crossings.end());
+
+		uint8_t* rowCells = cells.data() + (size_t)row * numberColumns;
+		const uint8_t* rowEdges = isEdgeCell.data() + (size_t)row * numberColumns;
+
+		for (int i = 0; i + 1 < crossings.size(); i += 2) {
+			int firstInside = std::max((int)ceil((crossings[i] - left) * inverseCellSize - 0.5f), 0);
+			int lastInside = std::min((int)ceil((crossings[i + 1] - left) * inverseCellSize - 0.5f) - 1, numberColumns - 1);
+
+			for (int column = firstInside; column <= lastInside; column++) {
+				if (!rowEdges[column]) rowCells[column] |= inside;
+			}
+		}
+	}
+
+	// only this filter's box was touched
+	for (int row = firstRow; row <= lastRow; row++) {
+		uint8_t* rowEdges = isEdgeCell.data() + (size_t)row * numberColumns;
+		std::fill(rowEdges + firstColumn, rowEdges + lastColumn + 1, 0);
+	}
+}
+
+void FilterGrid::rasterizeEllipse(const EllipseFilter& ellipse, bool isMask) {
+	uint8_t inside = isMask ? MaskInside : IncludeInside;
+	uint8_t boundary = isMask ? MaskBoundary : IncludeBoundary;
+
+	float maxRadius = std::max(ellipse.xRadius, ellipse.yRadius);
+	float minRadius = std::min(ellipse.xRadius, ellipse.yRadius);
+	if (minRadius <= 0) return;
+
+	int firstRow = ofClamp((int)floor((ellipse.center.y - maxRadius - top) * inverseCellSize), 0, numberRows - 1);
+	int lastRow = ofClamp((int)floor((ellipse.center.y + maxRadius - top) * inverseCellSize), 0, numberRows - 1);
+	int firstColumn = ofClamp((int)floor((ellipse.center.x - maxRadius - left) * inverseCellSize), 0, numberColumns - 1);
+	int lastColumn = ofClamp((int)floor((ellipse.center.x + maxRadius - left) * inverseCellSize), 0, numberColumns - 1);
+
+	// moving a point by d changes its normalized radius by at most d / minRadius, so
+	// a cell whose center is further than that from 1 over half its diagonal lies
+	// entirely on one side of the ellipse
+	float margin = cellSize * 0.5f * sqrt(2.0f) / minRadius;
+	float inverseA2 = 1.0f / (ellipse.xRadius * ellipse.xRadius);
+	float inverseB2 = 1.0f / (ellipse.yRadius * ellipse.yRadius);
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		float dy = top + (row + 0.5f) * cellSize - ellipse.center.y;
+		uint8_t* rowCells = cells.data() + (size_t)row * numberColumns;
+
+		for (int column = firstColumn; column <= lastColumn; column++) {
+			float dx = left + (column + 0.5f) * cellSize - ellipse.center.x;
+			float u = dx * ellipse.rotationCos + dy * ellipse.rotationSin;
+			float v = dy * ellipse.rotationCos - dx * ellipse.rotationSin;
+			float radius = sqrt(u * u * inverseA2 + v * v * inverseB2);
+
+			if (fabs(radius - 1.0f) <= margin) rowCells[column] |= boundary;
+			else if (radius < 1.0f) rowCells[column] |= inside;
+		}
+	}
+}
+
+void FilterGrid::markEdge(float ax, float ay, float bx, float by, uint8_t coverage) {
+	// grid units, then every cell the segment passes through row by row
+	ax = (ax - left) * inverseCellSize;
+	ay = (ay - top) * inverseCellSize;
+	bx = (bx - left) * inverseCellSize;
+	by = (by - top) * inverseCellSize;
+
+	float minY = std::min(ay, by);
+	float maxY = std::max(ay, by);
+	int firstRow = std::max((int)floor(minY), 0);
+	int lastRow = std::min((int)floor(maxY), numberRows - 1);
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		float x0 = ax;
+		float x1 = bx;
+
+		if (maxY - minY > 1e-6f) {
+			float y0 = std::max((float)row, minY);
+			float y1 = std::min((float)row + 1.0f, maxY);
+			float slope = (bx - ax) / (by - ay);
+			x0 = ax + (y0 - ay) * slope;
+			x1 = ax + (y1 - ay) * slope;
+		}
+
+		int firstColumn = std::max((int)floor(std::min(x0, x1)), 0);
+		int lastColumn = std::min((int)floor(std::max(x0, x1)), numberColumns - 1);
+
+		size_t offset = (size_t)row * numberColumns;
+		for (int column = firstColumn; column <= lastColumn; column++) {
+			cells[offset + column] |= coverage;
+			isEdgeCell[offset + column] = 1;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+//
+//  FilterGrid.hpp
+//  meatbags
+
+#ifndef FilterGrid_hpp
+#define FilterGrid_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+#include "Filter.hpp"
+#include "EllipseFilter.hpp"
+
+// the filters rasterized over the box around all of them, so checking a point
+// is one cell lookup instead of a polygon test per filter. only cells an
+// outline passes through still need the exact test
+class FilterGrid {
+public:
+	enum Cell : uint8_t {
+		Empty,
+		Include,
+		Mask,
+		Boundary
+	};
+
+	FilterGrid();
+
+	void build(const vector<Filter*>& filters, float resolution);
+
+	// coordinates in meters
+	inline Cell lookup(float x, float y) const {
+		int column = (int)floor((x - left) * inverseCellSize);
+		int row = (int)floor((y - top) * inverseCellSize);
+		if (column < 0 || row < 0 || column >= numberColumns || row >= numberRows) return Empty;
+		return (Cell)cells[row * numberColumns + column];
+	}
+
+	int getNumberBoundaryCells() const { return numberBoundaryCells; }
+	int getNumberCells() const { return cells.size(); }
+	float getCellSize() const { return cellSize; }
+	float getResolution() const { return resolution; }
+
+private:
+	// per filter coverage of a cell, combined into a Cell once every filter is drawn
+	enum Coverage : uint8_t {
+		IncludeInside   = 1,
+		IncludeBoundary = 2,
+		MaskInside      = 4,
+		MaskBoundary    = 8
+	};
+
+	void rasterize(const ofPolyline& polyline, bool isMask);
+	void rasterizeEllipse(const EllipseFilter& ellipse, bool isMask);
+	void markEdge(float ax, float ay, float bx, float by, uint8_t coverage);
+
+	vector<uint8_t> cells;
+	vector<uint8_t> isEdgeCell;
+	vector<float> crossings;
+
+	float left, top;
+	float resolution, cellSize, inverseCellSize;
+	int numberColumns, numberRows;
+	int numberBoundaryCells;
+
+	// coarser cells are used when the filters are spread too far apart for the resolution
+	static const int MAX_CELLS = 4000000;
+};
+
+#endif /* FilterGrid_hpp */
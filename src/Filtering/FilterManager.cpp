@@ -5,6 +5,7 @@
 #include "FilterManager.hpp"
 
 FilterManager::FilterManager() {
+	gridResolution = 0.01;
 }
 
 FilterManager::~FilterManager() {
@@ -45,11 +46,13 @@ void FilterManager::addFilter(FilterType type) {
 	filter->updateNormalization();
 
 	filterEntries.push_back({ std::move(filter) });
+	updateFilterGrid();
 }
 
 void FilterManager::removeFilter() {
 	if (filterEntries.size() > 1) {
 		filterEntries.pop_back();
+		updateFilterGrid();
 	}
 }
 
@@ -66,6 +69,8 @@ void FilterManager::changeFilterType(int index, FilterType newType) {
 
 	transferFilterState(oldFilter, newFilter.get());
 	entry.filter = std::move(newFilter);
+	entry.filter->update();
+	updateFilterGrid();
 }
 
 void FilterManager::update() {
@@ -83,6 +88,27 @@ void FilterManager::update() {
 			if (newType != currentType) changeFilterType(i, newType);
 		}
 	}
+
+	updateFilterGrid();
+}
+
+void FilterManager::updateFilterGrid() {
+	// runs whenever a filter is added, removed or retyped too, so the grid never keeps
+	// cells for a filter that is gone. versions are unique across filters
+	vector<unsigned int> versions;
+	for (auto& entry : filterEntries) {
+		versions.push_back(entry.filter->geometryVersion);
+		versions.push_back(entry.filter->isMask ? 1 : 0);
+	}
+
+	if (versions == gridVersions && gridResolution == filterGrid.getResolution()) return;
+	gridVersions.swap(versions);
+
+	filterGrid.build(getFilters(), gridResolution);
+}
+
+const FilterGrid* FilterManager::getFilterGrid() {
+	return &filterGrid;
 }
 
 void FilterManager::transferFilterState(Filter* oldFilter, Filter* newFilter) {
@@ -195,6 +221,7 @@ bool FilterManager::onKeyPressed(ofKeyEventArgs& keyArgs) {
 
 void FilterManager::saveTo(ofJson& config) {
 	config["number_filters"] = filterEntries.size();
+	config["filter_grid_resolution"] = gridResolution;
 	for (int i = 0; i < filterEntries.size(); i++) {
 		string key = "filter_" + to_string(i + 1);
 		Filter* f  = filterEntries[i].filter.get();
@@ -242,6 +269,10 @@ void FilterManager::loadFilters(int n, ofJson& config) {
 }
 
 void FilterManager::load(ofJson config) {
+	if (config.contains("filter_grid_resolution")) {
+		gridResolution = ofClamp(config["filter_grid_resolution"].get<float>(), 0.001, 0.5);
+	}
+
 	if (config.contains("number_filters")) {
 		int n = config["number_filters"];
 		loadFilters(n, config);
@@ -10,6 +10,7 @@
 #include "Filter.hpp"
 #include "QuadFilter.hpp"
 #include "EllipseFilter.hpp"
+#include "FilterGrid.hpp"
 #include "Space.h"
 #include "Blob.hpp"
 
@@ -47,6 +48,9 @@ public:
 	bool onKeyPressed(ofKeyEventArgs& keyArgs);
 
 	vector<Filter*> getFilters();
+	const FilterGrid* getFilterGrid();
+
+	float gridResolution;   // m
 
 private:
 	struct FilterEntry {
@@ -64,6 +68,11 @@ private:
 	string     filterTypeToString(FilterType type);
 
 	ofPoint defaultPosition(int index);
+
+	// rebuilt only when a geometry version or a mask flag differs from the last build
+	void updateFilterGrid();
+	FilterGrid filterGrid;
+	vector<unsigned int> gridVersions;
 };
 
 #endif /* FilterManager_hpp */
@@ -25,6 +25,8 @@ void QuadFilter::reset() {
 }
 
 void QuadFilter::update() {
+    if (!updateGeometryVersion()) return;
+
     polyline.clear();
     for (auto anchorPoint : anchorPoints) {
         polyline.addVertex(ofPoint(anchorPoint));
@@ -32,6 +34,7 @@ void QuadFilter::update() {
     polyline.close();
     
     Filter::update();
+    updateHomography();
 }
 
 void QuadFilter::updateHomography() {
@@ -4,11 +4,11 @@
 
 #include "MeatbagsPanel.hpp"
 
-static const int NUM_PARAMS = 4;
-static const char* PARAM_LABELS[] = { "epsilon", "min points", "persistence", "vel smooth" };
+static const int NUM_PARAMS = 6;
+static const char* PARAM_LABELS[] = { "epsilon", "min points", "persistence", "match dist", "process noise", "meas noise" };
 
 const std::vector<std::string>& MeatbagsPanel::clustererNames() {
-	static std::vector<std::string> names = { "DBSCAN", "Euclidean" };
+	static std::vector<std::string> names = { "DBSCAN", "Euclidean", "Segment" };
 	return names;
 }
 
@@ -135,7 +135,9 @@ MeatbagsPanel::ParamInfo MeatbagsPanel::getParamInfo(int p, Meatbags* m) {
 		case 0: info.value = m->epsilon;         info.min = m->epsilon.getMin();         info.max = m->epsilon.getMax();         break;
 		case 1: info.value = m->minPoints;        info.min = m->minPoints.getMin();       info.max = m->minPoints.getMax();       break;
 		case 2: info.value = m->blobPersistence;   info.min = m->blobPersistence.getMin();   info.max = m->blobPersistence.getMax();   break;
-		case 3: info.value = m->velocitySmoothing; info.min = m->velocitySmoothing.getMin(); info.max = m->velocitySmoothing.getMax(); break;
+		case 3: info.value = m->matchDistance;     info.min = m->matchDistance.getMin();     info.max = m->matchDistance.getMax();     break;
+		case 4: info.value = m->processNoise;      info.min = m->processNoise.getMin();      info.max = m->processNoise.getMax();      break;
+		case 5: info.value = m->measurementNoise;  info.min = m->measurementNoise.getMin();  info.max = m->measurementNoise.getMax();  break;
 	}
 	return info;
 }
@@ -145,7 +147,9 @@ void MeatbagsPanel::setParamValue(int p, float value, Meatbags* m) {
 		case 0: m->epsilon        = ofClamp(value, m->epsilon.getMin(),         m->epsilon.getMax());         break;
 		case 1: m->minPoints      = ofClamp(value, m->minPoints.getMin(),       m->minPoints.getMax());       break;
 		case 2: m->blobPersistence  = ofClamp(value, m->blobPersistence.getMin(),  m->blobPersistence.getMax());  break;
-		case 3: m->velocitySmoothing = ofClamp(value, m->velocitySmoothing.getMin(), m->velocitySmoothing.getMax()); break;
+		case 3: m->matchDistance     = ofClamp(value, m->matchDistance.getMin(),     m->matchDistance.getMax());     break;
+		case 4: m->processNoise      = ofClamp(value, m->processNoise.getMin(),      m->processNoise.getMax());      break;
+		case 5: m->measurementNoise  = ofClamp(value, m->measurementNoise.getMin(),  m->measurementNoise.getMax());  break;
 	}
 }
 
@@ -337,6 +341,8 @@ bool MeatbagsPanel::onMousePressed(ofMouseEventArgs& args, const std::vector<Mea
 						meatbags[i]->setClusterer(std::make_unique<DBSCANClusterer>());
 					} else if (names[j] == "Euclidean") {
 						meatbags[i]->setClusterer(std::make_unique<EuclideanClusterer>());
+					} else if (names[j] == "Segment") {
+						meatbags[i]->setClusterer(std::make_unique<SegmentClusterer>());
 					}
 					clustererDropdownOpen[i] = false;
 					return true;
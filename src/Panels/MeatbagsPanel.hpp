@@ -9,6 +9,7 @@
 #include "Meatbags.hpp"
 #include "DBSCANClusterer.hpp"
 #include "EuclideanClusterer.hpp"
+#include "SegmentClusterer.hpp"
 #include <vector>
 #include <functional>
 
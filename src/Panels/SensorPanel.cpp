@@ -5,7 +5,7 @@
 #include "SensorPanel.hpp"
 
 const std::vector<std::string>& SensorPanel::sensorTypeNames() {
-	static std::vector<std::string> names = { "Hokuyo", "Orbbec Pulsar" };
+	static std::vector<std::string> names = { "Hokuyo", "Orbbec Pulsar", "Orbbec Pulsar (TCP)", "Recording", "Simulation" };
 	return names;
 }
 
@@ -22,6 +22,9 @@ string SensorPanel::rowLabel(RowType type) {
 		case RowType::FogMode:      return "fog mode";
 		case RowType::FilterLevel:  return "filter level";
 		case RowType::Standby:      return "standby";
+		case RowType::LearnBackground:    return "learn background";
+		case RowType::SubtractBackground: return "subtract background";
+		case RowType::WindowToFilters:    return "window to filters";
 		default: return "";
 	}
 }
@@ -94,23 +97,53 @@ SensorPanel::SensorPanel() {
 // -----------------------------------------------------------------------------
 
 bool SensorPanel::isOrbbec(Sensor* s) {
+	return isOrbbecSDK(s) || dynamic_cast<OrbbecPulsar*>(s) != nullptr;
+}
+
+bool SensorPanel::isOrbbecSDK(Sensor* s) {
 	return dynamic_cast<OrbbecPulsarSDK*>(s) != nullptr;
 }
 
+bool SensorPanel::isRecording(Sensor* s) {
+	return dynamic_cast<Recording*>(s) != nullptr;
+}
+
+bool SensorPanel::isSimulation(Sensor* s) {
+	return dynamic_cast<Simulation*>(s) != nullptr;
+}
+
 std::vector<SensorPanel::RowType> SensorPanel::rowsForSensor(Sensor* s) {
-	std::vector<RowType> rows = {
-		RowType::TypeDropdown,
-		RowType::IPField,
-		RowType::WhichMeatbag,
-	};
-	if (isOrbbec(s)) {
+	std::vector<RowType> rows = { RowType::TypeDropdown };
+	if (!isSimulation(s)) {
+		rows.push_back(RowType::IPField);
+	}
+	rows.push_back(RowType::WhichMeatbag);
+	if (isOrbbec(s) || isSimulation(s)) {
 		rows.push_back(RowType::MotorSpeed);
 	}
 	rows.push_back(RowType::Position);
 	rows.push_back(RowType::Rotation);
-	if (isOrbbec(s)) {
+	if (isOrbbecSDK(s)) {
+		// the filter level is only reachable through the SDK
 		rows.push_back(RowType::FilterLevel);
 	}
+	if (isSimulation(s)) {
+		// the crowd is shared, these rows edit it for every simulated sensor
+		rows.push_back(RowType::Walkers);
+		rows.push_back(RowType::WalkerSpeed);
+	}
+	rows.push_back(RowType::LearnBackground);
+	rows.push_back(RowType::SubtractBackground);
+	rows.push_back(RowType::BackgroundTolerance);
+	rows.push_back(RowType::BackgroundAdaptation);
+	rows.push_back(RowType::WindowToFilters);
+	if (isRecording(s)) {
+		// mirroring is baked into a recording's angles
+		rows.push_back(RowType::PlaybackSpeed);
+		rows.push_back(RowType::PlaybackPosition);
+		rows.push_back(RowType::ShowInfo);
+		return rows;
+	}
 	rows.push_back(RowType::MirrorAngles);
 	if (isOrbbec(s)) {
 		rows.push_back(RowType::FogMode);
@@ -237,6 +270,60 @@ SensorPanel::SliderInfo SensorPanel::getSliderInfo(RowType type, Sensor* s) {
 			}
 			break;
 		}
+		case RowType::PlaybackSpeed: {
+			auto* recording = dynamic_cast<Recording*>(s);
+			info.label = "speed";
+			if (recording) {
+				info.value = recording->playbackSpeed;
+				info.min   = recording->playbackSpeed.getMin();
+				info.max   = recording->playbackSpeed.getMax();
+			}
+			break;
+		}
+		case RowType::PlaybackPosition: {
+			auto* recording = dynamic_cast<Recording*>(s);
+			info.label = "position";
+			if (recording) {
+				info.value = (float)recording->getPosition();
+				info.max   = (float)recording->getDuration();
+			}
+			break;
+		}
+		case RowType::Walkers: {
+			auto* simulation = dynamic_cast<Simulation*>(s);
+			info.label = "walkers";
+			info.isInt = true;
+			if (simulation && simulation->scene) {
+				info.value = (float)simulation->scene->numberWalkers.get();
+				info.min   = (float)simulation->scene->numberWalkers.getMin();
+				info.max   = (float)simulation->scene->numberWalkers.getMax();
+			}
+			break;
+		}
+		case RowType::WalkerSpeed: {
+			auto* simulation = dynamic_cast<Simulation*>(s);
+			info.label = "walk m/s";
+			if (simulation && simulation->scene) {
+				info.value = simulation->scene->walkerSpeed;
+				info.min   = simulation->scene->walkerSpeed.getMin();
+				info.max   = simulation->scene->walkerSpeed.getMax();
+			}
+			break;
+		}
+		case RowType::BackgroundTolerance:
+			info.label = "bg mm";
+			info.value = s->background.tolerance;
+			info.min   = s->background.tolerance.getMin();
+			info.max   = s->background.tolerance.getMax();
+			info.isInt = true;
+			break;
+		case RowType::BackgroundAdaptation:
+			info.label = "bg mm/s";
+			info.value = s->background.adaptation;
+			info.min   = s->background.adaptation.getMin();
+			info.max   = s->background.adaptation.getMax();
+			info.isInt = true;
+			break;
 		default: break;
 	}
 	return info;
@@ -250,6 +337,42 @@ void SensorPanel::setSliderValue(RowType type, float value, Sensor* s) {
 			if (sdk) sdk->guiFilterLevel = (int)ofClamp(value, sdk->guiFilterLevel.getMin(), sdk->guiFilterLevel.getMax());
 			break;
 		}
+		case RowType::PlaybackSpeed: {
+			auto* recording = dynamic_cast<Recording*>(s);
+			if (recording) recording->playbackSpeed = ofClamp(value, recording->playbackSpeed.getMin(), recording->playbackSpeed.getMax());
+			break;
+		}
+		case RowType::PlaybackPosition: {
+			auto* recording = dynamic_cast<Recording*>(s);
+			if (recording) recording->seek(ofClamp(value, 0.0f, (float)recording->getDuration()));
+			break;
+		}
+		case RowType::Walkers: {
+			auto* simulation = dynamic_cast<Simulation*>(s);
+			if (simulation && simulation->scene) {
+				auto& walkers = simulation->scene->numberWalkers;
+				walkers = (int)ofClamp(value, walkers.getMin(), walkers.getMax());
+			}
+			break;
+		}
+		case RowType::WalkerSpeed: {
+			auto* simulation = dynamic_cast<Simulation*>(s);
+			if (simulation && simulation->scene) {
+				auto& speed = simulation->scene->walkerSpeed;
+				speed = ofClamp(value, speed.getMin(), speed.getMax());
+			}
+			break;
+		}
+		case RowType::BackgroundTolerance: {
+			auto& tolerance = s->background.tolerance;
+			tolerance = ofClamp(value, tolerance.getMin(), tolerance.getMax());
+			break;
+		}
+		case RowType::BackgroundAdaptation: {
+			auto& adaptation = s->background.adaptation;
+			adaptation = ofClamp(value, adaptation.getMin(), adaptation.getMax());
+			break;
+		}
 		default: break;
 	}
 }
@@ -260,6 +383,9 @@ bool SensorPanel::getCheckboxValue(RowType type, Sensor* s) {
 		case RowType::ShowInfo:     return s->showSensorInformation;
 		case RowType::FogMode:      return s->guiSpecialWorkingMode;
 		case RowType::Standby:      return s->isSleeping;
+		case RowType::LearnBackground:    return s->background.isLearning();
+		case RowType::SubtractBackground: return s->background.isSubtracting;
+		case RowType::WindowToFilters:    return s->isWindowed;
 		default: return false;
 	}
 }
@@ -270,6 +396,10 @@ void SensorPanel::setCheckboxValue(RowType type, bool value, Sensor* s) {
 		case RowType::ShowInfo:     s->showSensorInformation = value; break;
 		case RowType::FogMode:      s->guiSpecialWorkingMode = value; break;
 		case RowType::Standby:      s->isSleeping            = value; break;
+		// clears itself once the background is learned
+		case RowType::LearnBackground:    if (value) s->background.learn(); break;
+		case RowType::SubtractBackground: s->background.isSubtracting = value; break;
+		case RowType::WindowToFilters:    s->isWindowed = value; break;
 		default: break;
 	}
 }
@@ -392,7 +522,9 @@ void SensorPanel::drawInstance(int i, Sensor* s, const std::vector<Sensor*>& sen
 	ofDrawLine(typeRow.x, typeRow.getBottom(), typeRow.getRight(), typeRow.getBottom());
 
 	string currentType = dynamic_cast<OrbbecPulsarSDK*>(s) ? "Orbbec Pulsar"
-					   : false ? "Orbbec Pulsar"
+					   : dynamic_cast<OrbbecPulsar*>(s) ? "Orbbec Pulsar (TCP)"
+					   : dynamic_cast<Recording*>(s) ? "Recording"
+					   : dynamic_cast<Simulation*>(s) ? "Simulation"
 					   : "Hokuyo";
 	ofSetColor(textColor);
 	ofDrawBitmapString("type", typeRow.x + padding, typeRow.y + 13);
@@ -444,7 +576,7 @@ void SensorPanel::drawInstance(int i, Sensor* s, const std::vector<Sensor*>& sen
 			ofFill();
 
 			ofSetColor(dimTextColor);
-			ofDrawBitmapString("IP", row.x + padding, row.y + 13);
+			ofDrawBitmapString(isRecording(s) ? "file" : "IP", row.x + padding, row.y + 13);
 			float ipW = display.length() * 8;
 			ofSetColor(editing ? textColor : dimTextColor);
 			ofDrawBitmapString(display, rowRight - ipW - padding, row.y + 13);
@@ -490,7 +622,9 @@ void SensorPanel::drawInstance(int i, Sensor* s, const std::vector<Sensor*>& sen
 			ofDrawBitmapString(yStr, yBox.getRight() - yStr.length() * 8 - padding, row.y + 13);
 
 		} else if (type == RowType::MirrorAngles || type == RowType::ShowInfo ||
-				   type == RowType::FogMode       || type == RowType::Standby) {
+				   type == RowType::FogMode       || type == RowType::Standby ||
+				   type == RowType::LearnBackground || type == RowType::SubtractBackground ||
+				   type == RowType::WindowToFilters) {
 			ofFill();
 			ofSetColor(controlRowColor);
 			ofDrawRectangle(row);
@@ -871,7 +1005,9 @@ bool SensorPanel::onMousePressed(ofMouseEventArgs& args, const std::vector<Senso
 				continue;
 
 			} else if (type == RowType::MirrorAngles || type == RowType::ShowInfo ||
-					   type == RowType::FogMode       || type == RowType::Standby) {
+					   type == RowType::FogMode       || type == RowType::Standby ||
+					   type == RowType::LearnBackground || type == RowType::SubtractBackground ||
+				   type == RowType::WindowToFilters) {
 				if (row.inside(mouse)) {
 					setCheckboxValue(type, !getCheckboxValue(type, sensors[i]), sensors[i]);
 					return true;
@@ -1121,6 +1257,9 @@ bool SensorPanel::onKeyPressed(ofKeyEventArgs& args, const std::vector<Sensor*>&
 		if (key == OF_KEY_BACKSPACE) { if (!editIPText.empty()) editIPText.pop_back(); return true; }
 		char c = (char)key;
 		if (std::isdigit(c) || c == '.' || std::isalpha(c)) { editIPText += c; return true; }
+		// recordings take a path relative to the data folder
+		bool isPath = isRecording(sensors[editIPInstance]);
+		if (isPath && (c == '/' || c == '\\' || c == '_' || c == '-' || c == ':')) { editIPText += c; return true; }
 		return false;
 	}
 
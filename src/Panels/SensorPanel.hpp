@@ -8,7 +8,10 @@
 #include "ofMain.h"
 #include "Sensor.hpp"
 #include "Hokuyo.hpp"
+#include "OrbbecPulsar.hpp"
 #include "OrbbecPulsarSDK.hpp"
+#include "Recording.hpp"
+#include "Simulation.hpp"
 #include <vector>
 #include <functional>
 
@@ -49,12 +52,24 @@ private:
 		MotorSpeed,
 		FogMode,
 		FilterLevel,
-		Standby
+		Standby,
+		PlaybackSpeed,
+		PlaybackPosition,
+		Walkers,
+		WalkerSpeed,
+		LearnBackground,
+		SubtractBackground,
+		BackgroundTolerance,
+		BackgroundAdaptation,
+		WindowToFilters
 	};
 
 	std::vector<RowType> rowsForSensor(Sensor* s);
 	int numRows(Sensor* s);
 	bool isOrbbec(Sensor* s);
+	bool isOrbbecSDK(Sensor* s);
+	bool isRecording(Sensor* s);
+	bool isSimulation(Sensor* s);
 
 	// -------------------------------------------------------------------------
 	// Layout
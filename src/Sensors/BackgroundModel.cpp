@@ -0,0 +1,147 @@
+//
+//  BackgroundModel.cpp
+//  meatbags
+
+#include "BackgroundModel.hpp"
+
+BackgroundModel::BackgroundModel() {
+	isSubtracting.set("subtract background", false);
+	tolerance.set("background tolerance", 150.0f, 20.0f, 1000.0f);
+	adaptation.set("background adaptation", 20.0f, 0.0f, 500.0f);
+
+	numberLearnedScans = 0;
+	lastApplyTime = std::chrono::steady_clock::now();
+}
+
+void BackgroundModel::learn() {
+	isLearnRequested = true;
+}
+
+bool BackgroundModel::isLearning() {
+	return isLearnRequested || isLearningScans;
+}
+
+bool BackgroundModel::hasBackground() {
+	std::lock_guard<std::mutex> lock(modelMutex);
+	return !backgroundRanges.empty();
+}
+
+void BackgroundModel::apply(const float* ranges, uint8_t* isValid, int numberSteps) {
+	std::lock_guard<std::mutex> lock(modelMutex);
+
+	auto now = std::chrono::steady_clock::now();
+	float deltaTime = std::min(std::chrono::duration<float>(now - lastApplyTime).count(), 1.0f);
+	lastApplyTime = now;
+
+	// a resolution change mid-burst starts the burst over
+	size_t learnSize = (size_t)numberSteps * LEARN_SCANS;
+	if (isLearnRequested.exchange(false) || (isLearningScans && learnSamples.size() != learnSize)) {
+		learnSamples.assign(learnSize, NO_RETURN_RANGE);
+		numberLearnedScans = 0;
+		isLearningScans = true;
+	}
+
+	if (isLearningScans) {
+		// step major, so each step's samples are contiguous when the percentile is taken
+		for (int i = 0; i < numberSteps; i++) {
+			learnSamples[(size_t)i * LEARN_SCANS + numberLearnedScans] = isValid[i] ? ranges[i] : NO_RETURN_RANGE;
+		}
+
+		numberLearnedScans++;
+		if (numberLearnedScans == LEARN_SCANS) finishLearning(numberSteps);
+	}
+
+	if (backgroundRanges.empty()) return;
+	if (backgroundRanges.size() != numberSteps) {
+		ofLogNotice("BackgroundModel") << "Sensor resolution changed, background has to be learned again";
+		backgroundRanges.clear();
+		return;
+	}
+
+	// running percentile, a return above the background nudges it up by PERCENTILE of
+	// a step and one below nudges it down by the rest, so it settles where PERCENTILE
+	// of the returns fall short of it. open space is never adapted into background
+	float stepSize = adaptation * deltaTime;
+	float stepUp = stepSize * PERCENTILE;
+	float stepDown = stepSize * (1.0f - PERCENTILE);
+	float maxDeviation = tolerance;
+	bool isMasking = isSubtracting;
+
+	float* background = backgroundRanges.data();
+
+	for (int i = 0; i < numberSteps; i++) {
+		float range = ranges[i];
+		bool hasReturn = isValid[i];
+		bool isLearned = background[i] < NO_RETURN_RANGE;
+
+		bool isBackground = hasReturn && fabs(range - background[i]) <= maxDeviation;
+		if (hasReturn && isLearned) background[i] += range > background[i] ? stepUp : -stepDown;
+
+		isValid[i] = hasReturn && !(isMasking && isBackground);
+	}
+}
+
+void BackgroundModel::finishLearning(int numberSteps) {
+	vector<float> learned(numberSteps, NO_RETURN_RANGE);
+
+	for (int i = 0; i < numberSteps; i++) {
+		float* samples = learnSamples.data() + (size_t)i * LEARN_SCANS;
+
+		// dropouts are common on dark or glancing surfaces, the percentile is over
+		// returns only, and a step needs returns in at least half the scans
+		float* returnsEnd = std::partition(samples, samples + LEARN_SCANS, [](float sample) {
+			return sample < NO_RETURN_RANGE;
+		});
+		int numberReturns = returnsEnd - samples;
+		if (numberReturns < LEARN_SCANS / 2) continue;
+
+		float* percentile = samples + (int)(PERCENTILE * (numberReturns - 1));
+		std::nth_element(samples, percentile, returnsEnd);
+		learned[i] = *percentile;
+	}
+
+	backgroundRanges.swap(learned);
+	vector<float>().swap(learnSamples);
+	isLearningScans = false;
+
+	int numberLearnedSteps = std::count_if(backgroundRanges.begin(), backgroundRanges.end(), [](float range) {
+		return range < NO_RETURN_RANGE;
+	});
+	ofLogNotice("BackgroundModel") << "Learned background on " << numberLearnedSteps << " of " << numberSteps << " steps";
+}
+
+void BackgroundModel::saveTo(ofJson& config) {
+	config["background"]["subtract"]   = isSubtracting.get();
+	config["background"]["tolerance"]  = tolerance.get();
+	config["background"]["adaptation"] = adaptation.get();
+
+	// whole mm, 0 for steps without background
+	vector<int> ranges;
+	{
+		std::lock_guard<std::mutex> lock(modelMutex);
+		ranges.reserve(backgroundRanges.size());
+		for (float range : backgroundRanges) {
+			ranges.push_back(range < NO_RETURN_RANGE ? (int)round(range) : 0);
+		}
+	}
+	config["background"]["ranges"] = ranges;
+}
+
+void BackgroundModel::load(ofJson& config) {
+	if (!config.contains("background")) return;
+	ofJson& bc = config["background"];
+
+	if (bc.contains("subtract"))   isSubtracting = bc["subtract"].get<bool>();
+	if (bc.contains("tolerance"))  tolerance     = bc["tolerance"].get<float>();
+	if (bc.contains("adaptation")) adaptation    = bc["adaptation"].get<float>();
+
+	if (bc.contains("ranges")) {
+		vector<int> ranges = bc["ranges"].get<vector<int>>();
+
+		std::lock_guard<std::mutex> lock(modelMutex);
+		backgroundRanges.resize(ranges.size());
+		for (int i = 0; i < ranges.size(); i++) {
+			backgroundRanges[i] = ranges[i] > 0 ? ranges[i] : NO_RETURN_RANGE;
+		}
+	}
+}
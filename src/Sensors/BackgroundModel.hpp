@@ -0,0 +1,55 @@
+//
+//  BackgroundModel.hpp
+//  meatbags
+
+#ifndef BackgroundModel_hpp
+#define BackgroundModel_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+
+// per step range of the static scene, walls, pillars and furniture, learned from a
+// burst of scans and then slowly adapted as a running percentile. returns within
+// tolerance of it are dropped at ingest, before filtering and clustering see them
+class BackgroundModel {
+public:
+	BackgroundModel();
+
+	// starts learning over the next scans, the previous background stays in use until it is done
+	void learn();
+	bool isLearning();
+	bool hasBackground();
+
+	// called with every new scan from the thread that projects it, before any
+	// windowing. isValid flags the steps with a return, background ones are cleared
+	void apply(const float* ranges, uint8_t* isValid, int numberSteps);
+
+	void saveTo(ofJson& sensorConfiguration);
+	void load(ofJson& sensorConfiguration);
+
+	ofParameter<bool>  isSubtracting;
+	ofParameter<float> tolerance;      // mm
+	ofParameter<float> adaptation;     // mm/s the percentile can move
+
+private:
+	void finishLearning(int numberSteps);
+
+	std::mutex modelMutex;
+	std::atomic<bool> isLearnRequested{ false };
+	std::atomic<bool> isLearningScans{ false };
+
+	vector<float> backgroundRanges;
+	vector<float> learnSamples;
+	int numberLearnedScans;
+	std::chrono::steady_clock::time_point lastApplyTime;
+
+	static const int LEARN_SCANS = 100;
+
+	// high percentile so people passing through during learning don't end up in the background
+	static constexpr float PERCENTILE = 0.8;
+
+	// steps without a background sit this far away, so no return ever matches them
+	static constexpr float NO_RETURN_RANGE = 100000.0;
+};
+
+#endif /* BackgroundModel_hpp */
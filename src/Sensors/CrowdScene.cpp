@@ -0,0 +1,142 @@
+//
+//  CrowdScene.cpp
+//  meatbags
+
+#include "CrowdScene.hpp"
+
+CrowdScene::CrowdScene() {
+	numberWalkers.set("walkers", 20, 0, 500);
+	walkerSpeed.set("walker speed", 1.3, 0.0, 3.0);
+	areaWidth.set("area width", 6.0, 1.0, 50.0);
+	areaDepth.set("area depth", 6.0, 1.0, 50.0);
+	centerX.set("center x", 0.0, -50.0, 50.0);
+	centerY.set("center y", 1.25, -50.0, 50.0);
+	torsoRadius.set("torso radius", 0.2, 0.1, 0.4);
+	isTorsoHeight.set("torso height", false);
+	hasWalls.set("walls", true);
+
+	// fixed seed so a load test replays the same crowd every run
+	random.seed(1);
+	sceneTimeUs = 0;
+}
+
+void CrowdScene::sample(uint64_t timeUs, vector<Circle>& bodies, vector<Segment>& outWalls) {
+	std::lock_guard<std::mutex> lock(sceneMutex);
+
+	// the first sensor to ask for a moment advances the crowd, later sensors see the same state
+	// after a long stall the crowd skips ahead instead of replaying every step
+	if (sceneTimeUs == 0 || (timeUs > sceneTimeUs && timeUs - sceneTimeUs > MAX_CATCH_UP_US)) sceneTimeUs = timeUs;
+	while (sceneTimeUs + STEP_US <= timeUs) {
+		step(STEP_US / 1000000.0f);
+		sceneTimeUs += STEP_US;
+	}
+
+	bodies.clear();
+	for (const auto& walker : walkers) {
+		if (isTorsoHeight) {
+			bodies.push_back({ walker.x, walker.y, torsoRadius * 1000.0f });
+			continue;
+		}
+
+		// legs sit either side of the heading and swing against each other with the gait
+		float forwardX = cos(walker.heading);
+		float forwardY = sin(walker.heading);
+		float swing = sin(walker.phase) * STRIDE_REACH;
+
+		bodies.push_back({ walker.x - forwardY * LEG_SPACING + forwardX * swing,
+						   walker.y + forwardX * LEG_SPACING + forwardY * swing, LEG_RADIUS });
+		bodies.push_back({ walker.x + forwardY * LEG_SPACING - forwardX * swing,
+						   walker.y - forwardX * LEG_SPACING - forwardY * swing, LEG_RADIUS });
+	}
+
+	updateWalls();
+	outWalls = walls;
+}
+
+void CrowdScene::step(float deltaTime) {
+	int target = std::max(numberWalkers.get(), 0);
+	while (walkers.size() > target) walkers.pop_back();
+	while (walkers.size() < target) {
+		Walker walker;
+		spawnWalker(walker);
+		walkers.push_back(walker);
+	}
+
+	float halfWidth = areaWidth * 500.0f;
+	float halfDepth = areaDepth * 500.0f;
+	float minX = centerX * 1000.0f - halfWidth, maxX = centerX * 1000.0f + halfWidth;
+	float minY = centerY * 1000.0f - halfDepth, maxY = centerY * 1000.0f + halfDepth;
+	float margin = isTorsoHeight ? torsoRadius * 1000.0f : LEG_SPACING + LEG_RADIUS;
+
+	std::normal_distribution<float> wander(0.0f, 0.8f * sqrt(deltaTime));
+
+	for (auto& walker : walkers) {
+		walker.heading += wander(random);
+
+		walker.x += cos(walker.heading) * walker.speed * walkerSpeed * deltaTime;
+		walker.y += sin(walker.heading) * walker.speed * walkerSpeed * deltaTime;
+		walker.phase += walker.speed * walkerSpeed * deltaTime / STRIDE_LENGTH * TWO_PI;
+
+		// turn back at the walls
+		if (walker.x < minX + margin || walker.x > maxX - margin) {
+			walker.heading = PI - walker.heading;
+			walker.x = ofClamp(walker.x, minX + margin, maxX - margin);
+		}
+		if (walker.y < minY + margin || walker.y > maxY - margin) {
+			walker.heading = -walker.heading;
+			walker.y = ofClamp(walker.y, minY + margin, maxY - margin);
+		}
+	}
+}
+
+void CrowdScene::spawnWalker(Walker& walker) {
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	walker.x = (centerX + (unit(random) - 0.5f) * areaWidth * 0.9f) * 1000.0f;
+	walker.y = (centerY + (unit(random) - 0.5f) * areaDepth * 0.9f) * 1000.0f;
+	walker.heading = unit(random) * TWO_PI;
+	// individual pace around the crowd speed, stored in mm per m/s of walkerSpeed
+	walker.speed = (0.7f + unit(random) * 0.6f) * 1000.0f;
+	walker.phase = unit(random) * TWO_PI;
+}
+
+void CrowdScene::updateWalls() {
+	walls.clear();
+	if (!hasWalls) return;
+
+	float minX = (centerX - areaWidth * 0.5f) * 1000.0f, maxX = (centerX + areaWidth * 0.5f) * 1000.0f;
+	float minY = (centerY - areaDepth * 0.5f) * 1000.0f, maxY = (centerY + areaDepth * 0.5f) * 1000.0f;
+
+	walls.push_back({ minX, minY, maxX, minY });
+	walls.push_back({ maxX, minY, maxX, maxY });
+	walls.push_back({ maxX, maxY, minX, maxY });
+	walls.push_back({ minX, maxY, minX, minY });
+}
+
+void CrowdScene::saveTo(ofJson& config) {
+	config["simulation"]["walkers"]       = numberWalkers.get();
+	config["simulation"]["walker_speed"]  = walkerSpeed.get();
+	config["simulation"]["area_width"]    = areaWidth.get();
+	config["simulation"]["area_depth"]    = areaDepth.get();
+	config["simulation"]["center_x"]      = centerX.get();
+	config["simulation"]["center_y"]      = centerY.get();
+	config["simulation"]["torso_radius"]  = torsoRadius.get();
+	config["simulation"]["torso_height"]  = isTorsoHeight.get();
+	config["simulation"]["walls"]         = hasWalls.get();
+}
+
+void CrowdScene::load(ofJson& config) {
+	if (!config.contains("simulation")) return;
+	ofJson& sc = config["simulation"];
+
+	std::lock_guard<std::mutex> lock(sceneMutex);
+	if (sc.contains("walkers"))      numberWalkers = sc["walkers"].get<int>();
+	if (sc.contains("walker_speed")) walkerSpeed   = sc["walker_speed"].get<float>();
+	if (sc.contains("area_width"))   areaWidth     = sc["area_width"].get<float>();
+	if (sc.contains("area_depth"))   areaDepth     = sc["area_depth"].get<float>();
+	if (sc.contains("center_x"))     centerX       = sc["center_x"].get<float>();
+	if (sc.contains("center_y"))     centerY       = sc["center_y"].get<float>();
+	if (sc.contains("torso_radius")) torsoRadius   = sc["torso_radius"].get<float>();
+	if (sc.contains("torso_height")) isTorsoHeight = sc["torso_height"].get<bool>();
+	if (sc.contains("walls"))        hasWalls      = sc["walls"].get<bool>();
+}
@@ -0,0 +1,71 @@
+//
+//  CrowdScene.hpp
+//  meatbags
+
+#ifndef CrowdScene_hpp
+#define CrowdScene_hpp
+
+#include <stdio.h>
+#include <random>
+#include "ofMain.h"
+
+// a walled floor with people wandering across it, shared by every simulated
+// sensor so overlapping sensors see the same crowd. all geometry is in world mm,
+// the same frame the sensors project their coordinates into
+class CrowdScene {
+public:
+	struct Circle {
+		float x, y, radius;
+	};
+
+	struct Segment {
+		float x1, y1, x2, y2;
+	};
+
+	CrowdScene();
+
+	// advances the crowd to timeUs and copies out its cross-sections, called from sensor threads
+	void sample(uint64_t timeUs, vector<Circle>& bodies, vector<Segment>& walls);
+
+	void saveTo(ofJson& configuration);
+	void load(ofJson& configuration);
+
+	ofParameter<int>   numberWalkers;
+	ofParameter<float> walkerSpeed;     // m/s
+	ofParameter<float> areaWidth;       // m
+	ofParameter<float> areaDepth;       // m
+	ofParameter<float> centerX;         // m
+	ofParameter<float> centerY;         // m
+	ofParameter<float> torsoRadius;     // m
+	ofParameter<bool>  isTorsoHeight;   // scan plane cuts torsos instead of legs
+	ofParameter<bool>  hasWalls;
+
+private:
+	struct Walker {
+		float x, y;
+		float heading;
+		float speed;   // mm/s
+		float phase;   // gait, radians
+	};
+
+	void step(float deltaTime);
+	void spawnWalker(Walker& walker);
+	void updateWalls();
+
+	std::mutex sceneMutex;
+	std::mt19937 random;
+
+	vector<Walker> walkers;
+	vector<Segment> walls;
+	uint64_t sceneTimeUs;
+
+	static const int STEP_US = 10000;
+	static const int MAX_CATCH_UP_US = 1000000;
+
+	static constexpr float LEG_RADIUS = 60.0;
+	static constexpr float LEG_SPACING = 90.0;
+	static constexpr float STRIDE_LENGTH = 1400.0;
+	static constexpr float STRIDE_REACH = 200.0;
+};
+
+#endif /* CrowdScene_hpp */
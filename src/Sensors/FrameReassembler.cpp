@@ -0,0 +1,108 @@
+//
+//  FrameReassembler.cpp
+//  meatbags
+
+#include "FrameReassembler.hpp"
+
+FrameReassembler::FrameReassembler(size_t capacity) {
+	buffer.resize(capacity);
+	numberStartBytes = 0;
+	std::fill(std::begin(isStartByte), std::end(isStartByte), false);
+	clear();
+}
+
+void FrameReassembler::setup(const vector<uint8_t>& startBytes, FrameSize _frameSize, FrameCheck _frameCheck) {
+	std::fill(std::begin(isStartByte), std::end(isStartByte), false);
+	numberStartBytes = 0;
+
+	for (auto startByte : startBytes) {
+		isStartByte[startByte] = true;
+		if (numberStartBytes < 2) firstStartBytes[numberStartBytes++] = startByte;
+	}
+
+	frameSize  = _frameSize;
+	frameCheck = _frameCheck;
+}
+
+void FrameReassembler::clear() {
+	head = 0;
+	tail = 0;
+	discardedBytes = 0;
+}
+
+uint8_t* FrameReassembler::getWriteBuffer(size_t& available) {
+	if (head == tail) {
+		head = 0;
+		tail = 0;
+	} else if (tail == buffer.size()) {
+		// only the unfinished frame at the end is moved, never more than one frame
+		memmove(buffer.data(), buffer.data() + head, tail - head);
+		tail -= head;
+		head  = 0;
+	}
+
+	available = buffer.size() - tail;
+	return buffer.data() + tail;
+}
+
+void FrameReassembler::commit(size_t length) {
+	tail = std::min(tail + length, buffer.size());
+}
+
+void FrameReassembler::skipToFrameStart() {
+	const uint8_t* data   = buffer.data() + head;
+	size_t         length = tail - head;
+	size_t         offset = length;
+
+	if (numberStartBytes <= 2) {
+		// memchr is vectorized by the C library, take the nearest of the start bytes
+		for (int i = 0; i < numberStartBytes; i++) {
+			const void* found = memchr(data, firstStartBytes[i], offset);
+			if (found) offset = static_cast<const uint8_t*>(found) - data;
+		}
+	} else {
+		for (offset = 0; offset < length; offset++) {
+			if (isStartByte[data[offset]]) break;
+		}
+	}
+
+	discardedBytes += offset;
+	head += offset;
+}
+
+bool FrameReassembler::nextFrame(const uint8_t*& frame, size_t& frameLength) {
+	while (head < tail) {
+		if (!isStartByte[buffer[head]]) {
+			skipToFrameStart();
+			continue;
+		}
+
+		const uint8_t* data   = buffer.data() + head;
+		size_t         length = tail - head;
+
+		int size = frameSize(data, length);
+		if (size == 0) return false;
+
+		// not a frame, or a header claiming more than we could ever hold, resync one byte on
+		if (size < 0 || (size_t)size > buffer.size()) {
+			head++;
+			discardedBytes++;
+			continue;
+		}
+
+		if ((size_t)size > length) return false;
+
+		if (frameCheck && !frameCheck(data, size)) {
+			head++;
+			discardedBytes++;
+			continue;
+		}
+
+		frame       = data;
+		frameLength = size;
+		head       += size;
+		return true;
+	}
+
+	return false;
+}
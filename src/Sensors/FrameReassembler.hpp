@@ -0,0 +1,51 @@
+//
+//  FrameReassembler.hpp
+//  meatbags
+
+#ifndef FrameReassembler_hpp
+#define FrameReassembler_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+
+// Reassembles length-prefixed binary frames from a TCP byte stream. Socket
+// reads go straight into the internal buffer and complete frames are handed
+// out in place, so nothing is copied or erased per frame. Consumed bytes are
+// only reclaimed when the write position reaches the end of the buffer.
+class FrameReassembler {
+public:
+	// returns the total size of the frame starting at data, 0 when more bytes
+	// are needed to tell, or -1 when data does not start a frame
+	typedef std::function<int(const uint8_t* data, size_t length)> FrameSize;
+	typedef std::function<bool(const uint8_t* data, size_t length)> FrameCheck;
+
+	FrameReassembler(size_t capacity = 65536);
+
+	void setup(const vector<uint8_t>& startBytes, FrameSize frameSize, FrameCheck frameCheck);
+	void clear();
+
+	// space to receive into, followed by commit() with the bytes actually read
+	uint8_t* getWriteBuffer(size_t& available);
+	void commit(size_t length);
+
+	// the returned frame stays valid until the next getWriteBuffer() call
+	bool nextFrame(const uint8_t*& frame, size_t& frameLength);
+
+	uint64_t getDiscardedBytes() const { return discardedBytes; }
+
+private:
+	void skipToFrameStart();
+
+	vector<uint8_t> buffer;
+	size_t head, tail;
+
+	bool       isStartByte[256];
+	uint8_t    firstStartBytes[2];
+	int        numberStartBytes;
+	FrameSize  frameSize;
+	FrameCheck frameCheck;
+
+	uint64_t discardedBytes;
+};
+
+#endif /* FrameReassembler_hpp */
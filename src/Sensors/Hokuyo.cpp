@@ -3,12 +3,15 @@
 //  meatbags
 
 #include "Hokuyo.hpp"
+#include "SensorReactor.hpp"
 
 Hokuyo::Hokuyo() {
 	// Hokuyo specific settings, 180 degrees, front facing range
 	angularResolution = 1440;
-	startStep = 0;
-	endStep = 1079;
+	startStep = FIRST_STEP;
+	endStep = LAST_STEP;
+	windowStartStep = FIRST_STEP;
+	windowEndStep = LAST_STEP;
 
 	port = 10940;
 
@@ -20,84 +23,119 @@ Hokuyo::Hokuyo() {
 }
 
 Hokuyo::~Hokuyo() {
+	disconnect();
 }
 
 void Hokuyo::update() {
-	updateDistances();
 	updateSensorInfo();
 }
 
 void Hokuyo::threadedFunction() {
-	bool tcpConnected = tcpSetup();
-	tcpClient.setMessageDelimiter("\012\012");
-	
-	if (tcpConnected) {
-		sendMeasurementModeOnCommand();
-		sendStreamDistancesCommand();
+	// only connects, from here on the socket is serviced by the reactor
+	if (!tcpSetup()) {
+		ofLogNotice("Hokuyo") << "Connection unsuccessful, retrying";
+		scheduleReconnect();
+		return;
 	}
-	
-	auto lastDataTime = std::chrono::steady_clock::now();
-	const auto timeoutDuration = std::chrono::seconds(3);
-	
-	auto lastStatusTime = std::chrono::steady_clock::now();
-	const auto statusInterval = std::chrono::milliseconds(1000);
 
-	auto lastReconnectionTime = std::chrono::steady_clock::now();
-	const auto reconnectionTimeout = std::chrono::milliseconds(5000);
-	
-	while(isThreadRunning()) {
-		string response;
+	isConnected = true;
+	tcpClient.setMessageDelimiter("\012\012");
+	lastDataTime = std::chrono::steady_clock::now();
+
+	sendMeasurementModeOnCommand();
+	sendStreamDistancesCommand();
+
+	attachToReactor();
+}
+
+bool Hokuyo::receive() {
+	// drain every complete frame so a backlog after a stall is caught up in one pass,
+	// frames are views into the client's buffer and only valid until the next receiveFrame
+	const char* frame;
+	size_t frameLength;
+	while (true) {
+		bool hasFrame;
 		{
 			std::lock_guard<std::mutex> lock(tcpMutex);
-			isConnected = tcpClient.isConnected();
-			response = tcpClient.receive();
+			hasFrame = tcpClient.receiveFrame(frame, frameLength);
 		}
+		if (!hasFrame) break;
 
-		if (response.length() > 0) {
-			parseResponse(response);
-			lastDataTime = std::chrono::steady_clock::now();
-		}
+		parseResponse(frame, frameLength);
+		lastDataTime = std::chrono::steady_clock::now();
+	}
 
+	std::lock_guard<std::mutex> lock(tcpMutex);
+	isConnected = tcpClient.isConnected();
+	return isConnected;
+}
+
+void Hokuyo::startTimers() {
+	reactor->addTimer(this, STATUS_INTERVAL_MS, [this]() {
+		sendStatusInfoCommand();
+		sendVersionInfoCommand();
+		sendParameterInfoCommand();
+	});
+
+	// restart streaming if the sensor went quiet
+	reactor->addTimer(this, DATA_WATCHDOG_INTERVAL_MS, [this]() {
 		auto now = std::chrono::steady_clock::now();
-		if (now - lastDataTime > timeoutDuration) {
+		if (now - lastDataTime > std::chrono::milliseconds(DATA_TIMEOUT_MS)) {
 			sendStreamDistancesCommand();
-			lastDataTime = std::chrono::steady_clock::now();
-		}
-		
-		if (now - lastStatusTime > statusInterval) {
-			sendStatusInfoCommand();
-			sendVersionInfoCommand();
-			sendParameterInfoCommand();
-			lastStatusTime = std::chrono::steady_clock::now();
+			lastDataTime = now;
 		}
+	});
 
-		bool connected;
-		{
-			std::lock_guard<std::mutex> lock(tcpMutex);
-			connected = tcpClient.isConnected();
-		}
+	reactor->addTimer(this, WINDOW_CHECK_INTERVAL_MS, [this]() { narrowSteps(); });
+}
 
-		if (!connected) {
-			if (now - lastReconnectionTime > reconnectionTimeout) {
-				ofLogNotice("Hokuyo") << "Connection lost, attempting reconnection";
+void Hokuyo::onWindowChanged(int firstStep, int lastStep) {
+	// nothing in view still streams the whole scan, it is dropped at projection
+	if (lastStep < firstStep) {
+		firstStep = FIRST_STEP;
+		lastStep = LAST_STEP;
+	}
 
-				if (tcpSetup()) {
-					ofLogNotice("Hokuyo") << "Reconnection successful";
+	firstStep = ofClamp(firstStep, FIRST_STEP, LAST_STEP);
+	lastStep = ofClamp(lastStep, FIRST_STEP, LAST_STEP);
 
-					tcpClient.setMessageDelimiter("\012\012");
-					sendMeasurementModeOnCommand();
-					sendStreamDistancesCommand();
-				} else {
-					ofLogNotice("Hokuyo") << "Reconnection unsuccessful";
-				}
+	std::lock_guard<std::mutex> lock(stepsMutex);
+	if (firstStep == windowStartStep && lastStep == windowEndStep) return;
 
-				lastReconnectionTime = std::chrono::steady_clock::now();
-			}
-		} else {
-			lastReconnectionTime = std::chrono::steady_clock::now();
-		}
-		
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	windowStartStep = firstStep;
+	windowEndStep = lastStep;
+	windowChangeTime = std::chrono::steady_clock::now();
+
+	// steps missing from the stream would be missing from the filters, widening can't wait
+	if (windowStartStep < startStep || windowEndStep > endStep) {
+		requestSteps(windowStartStep - WINDOW_MARGIN_STEPS, windowEndStep + WINDOW_MARGIN_STEPS);
+	}
+}
+
+void Hokuyo::narrowSteps() {
+	// runs on the reactor, extra steps only cost bandwidth so narrowing waits for the window to settle
+	std::lock_guard<std::mutex> lock(stepsMutex);
+	if (std::chrono::steady_clock::now() - windowChangeTime < std::chrono::milliseconds(WINDOW_SETTLE_MS)) return;
+
+	if (windowStartStep - startStep > 2 * WINDOW_MARGIN_STEPS || endStep - windowEndStep > 2 * WINDOW_MARGIN_STEPS) {
+		requestSteps(windowStartStep - WINDOW_MARGIN_STEPS, windowEndStep + WINDOW_MARGIN_STEPS);
+	}
+}
+
+void Hokuyo::requestSteps(int firstStep, int lastStep) {
+	// called with stepsMutex held, so the UI thread and the reactor never interleave a restart
+	int newStartStep = ofClamp(firstStep, FIRST_STEP, LAST_STEP);
+	int newEndStep = ofClamp(lastStep, FIRST_STEP, LAST_STEP);
+	if (newStartStep == startStep && newEndStep == endStep) return;
+
+	startStep = newStartStep;
+	endStep = newEndStep;
+
+	// a running MD stream can't be changed, stop it and request the new steps
+	if (isConnected) {
+		sendMeasurementModeOffCommand();
+		sendMeasurementModeOnCommand();
+		sendStreamDistancesCommand();
 	}
 }
 
@@ -157,10 +195,8 @@ void Hokuyo::sendGetDistancesAndIntensitiesCommand() {
 }
 
 void Hokuyo::send(string msg) {
-	std::lock_guard<std::mutex> lock(tcpMutex);
-	if (tcpClient.isConnected()) {
-		tcpClient.send(msg + "\012\012");
-	}
+	msg += "\012\012";
+	sendBytes(msg.data(), msg.size());
 }
 
 string Hokuyo::formatDistanceMessage(string command) {
@@ -204,8 +240,8 @@ void Hokuyo::updateSensorInfo() {
 	sensorInfoLines.emplace_back("protocol: " + protocolVersion);
 	sensorInfoLines.emplace_back("serial: " + serialNumber);
 	sensorInfoLines.emplace_back("laser state: " + laserState);
-	sensorInfoLines.emplace_back("polling start step: " + to_string(startStep));
-	sensorInfoLines.emplace_back("polling end step: " + to_string(endStep));
+	sensorInfoLines.emplace_back("polling start step: " + to_string(startStep.load()));
+	sensorInfoLines.emplace_back("polling end step: " + to_string(endStep.load()));
 	sensorInfoLines.emplace_back("measurement mode: " + measurementMode);
 	sensorInfoLines.emplace_back("bitrate: " + bitRate);
 	sensorInfoLines.emplace_back("timestamp: " + to_string(timeStamp));
@@ -223,6 +259,18 @@ void Hokuyo::updateSensorInfo() {
 	sensorInfoLines.emplace_back("scanning speed: " + scanningSpeed);
 }
 
+bool Hokuyo::verifyCheckSum(const char* line, size_t length, int fromEnd) {
+	if (length <= static_cast<size_t>(fromEnd)) return false;
+
+	size_t payloadLen = length - fromEnd;
+	int sum = 0;
+	for (size_t i = 0; i < payloadLen; ++i) {
+		sum += static_cast<unsigned char>(line[i]);
+	}
+
+	return ((sum & 0x3F) + 0x30) == static_cast<unsigned char>(line[length - 1]);
+}
+
 string Hokuyo::checkSum(string str, int fromEnd) {
 	if (str.size() <= static_cast<size_t>(fromEnd)) return "";
 	
@@ -244,15 +292,25 @@ string Hokuyo::checkSum(string str, int fromEnd) {
 }
 
 void Hokuyo::parseResponse(const string& str) {
-	vector<string> lines = splitStringByNewline(str);
+	parseResponse(str.data(), str.size());
+}
+
+void Hokuyo::parseResponse(const char* data, size_t length) {
+	if (length < 2) return;
+
+	// scans are decoded in place, everything else is low rate status traffic
+	if ((data[0] == 'M' || data[0] == 'G') && data[1] == 'D') {
+		parseDistances(data, length);
+		return;
+	}
+
+	vector<string> lines = splitStringByNewline(string(data, length));
 	if (lines.size() == 0 || lines.empty()) return;
 	
 	string& header = lines[0];
 	string command = header.substr(0, 2);
 	
-	if (command == "MD") parseStreamingDistances(lines);
-	else if (command == "GD") parseDistances(lines);
-	else if (command == "GE") parseDistancesAndIntensities(lines);
+	if (command == "GE") parseDistancesAndIntensities(lines);
 	else if (command == "BM") parseActivate(lines);
 	else if (command == "QT") parseQuiet(lines);
 	else if (command == "II") parseStatusInfo(lines);
@@ -261,84 +319,72 @@ void Hokuyo::parseResponse(const string& str) {
 	else if (command == "CR") parseMotorSpeed(lines);
 }
 
-void Hokuyo::parseStreamingDistances(vector<string> packet) {
-	if (packet.size() < 3) return;
-	
-	const string& header = packet[0];
-	int startStep = stoi(header.substr(2, 4));
-	int endStep = stoi(header.substr(6, 4));
-	int clusterCount = stoi(header.substr(10, 2));
-	
+void Hokuyo::parseDistances(const char* data, size_t length) {
+	const char* end     = data + length;
+	const char* line    = data;
+	const char* lineEnd = findLineEnd(line, end);
+
+	// echo line, e.g. MD0000107901...
+	if (lineEnd - line < 12) return;
+	int scanStartStep = decodeDecimal(line + 2, 4);
+	int scanEndStep   = decodeDecimal(line + 6, 4);
+	if (scanStartStep < 0 || scanEndStep < scanStartStep) return;
+
 	// validate status and timestamp
-	if (checkSum(packet[1], 1).empty()) return;
-	if (checkSum(packet[2], 1).empty()) return;
-	
-	const int expectedDataPoints = (endStep - startStep + 1);
-	const int expectedChars = expectedDataPoints * 3;
-	
-	string concatenatedData;
-	concatenatedData.reserve(expectedChars);
-	
-	for (int i = 3; i < packet.size(); i++) {
-		string decoded = checkSum(packet[i], 1);
-		if (decoded.empty()) continue;
-		concatenatedData += decoded;
+	for (int i = 0; i < 2; i++) {
+		if (lineEnd >= end) return;
+		line    = lineEnd + 1;
+		lineEnd = findLineEnd(line, end);
+		if (!verifyCheckSum(line, lineEnd - line, 1)) return;
 	}
-	
-	if (concatenatedData.length() < expectedChars) return;
-	const char* raw = concatenatedData.c_str();
-	size_t numSteps = endStep - startStep + 1;
-	
-	int step = startStep;
-	for (int i = 0; i < numSteps; i++) {
-		int distance = sixBitCharDecode(raw + (i * 3), 3);
-		{
-			std::lock_guard<std::mutex> lock(distancesMutex);
-			distances[step] = distance;
+
+	vector<float>& scan = distances.getWriteBuffer();
+	if (scanEndStep >= (int)scan.size()) return;
+
+	// a windowed request leaves the rest of the buffer from an older scan
+	std::fill(scan.begin(), scan.begin() + scanStartStep, 0.0f);
+	std::fill(scan.begin() + scanEndStep + 1, scan.end(), 0.0f);
+
+	float* output    = scan.data() + scanStartStep;
+	int numberSteps  = scanEndStep - scanStartStep + 1;
+	int decoded      = 0;
+	int partialValue = 0;
+	int partialChars = 0;
+
+	// data lines hold 64 chars + checksum, so a 3 char value can straddle two lines
+	while (lineEnd < end && decoded < numberSteps) {
+		line    = lineEnd + 1;
+		lineEnd = findLineEnd(line, end);
+		if (!verifyCheckSum(line, lineEnd - line, 1)) return;
+
+		const char* c          = line;
+		const char* payloadEnd = lineEnd - 1;
+
+		while (partialChars > 0 && c < payloadEnd) {
+			partialValue = (partialValue << 6) | (*c++ - 0x30);
+			if (++partialChars == 3) {
+				output[decoded++] = partialValue;
+				partialValue = 0;
+				partialChars = 0;
+			}
 		}
-		step += 1;
-	}
-	
-	std::lock_guard<std::mutex> lock(distancesAvailableMutex);
-	newDistancesAvailable = true;
-}
 
-void Hokuyo::parseDistances(vector<string> packet) {
-	if (packet.size() < 2) return;
-	
-	const string& header = packet[0];
-	int startStep = stoi(header.substr(2, 4));
-	int endStep = stoi(header.substr(6, 4));
-	int clusterCount = stoi(header.substr(10, 2));
-	
-	// validate status and timestamp
-	if (checkSum(packet[1], 1).empty()) return;
-	if (checkSum(packet[2], 1).empty()) return;
-	
-	const int expectedDataPoints = (endStep - startStep + 1);
-	const int expectedChars = expectedDataPoints * 3;
-	
-	string concatenatedData;
-	concatenatedData.reserve(expectedChars);
-	
-	for (int i = 3; i < packet.size(); i++) {
-		string decoded = checkSum(packet[i], 1);
-		if (decoded.empty()) continue;
-		concatenatedData += decoded;
-	}
-	
-	const char* raw = concatenatedData.c_str();
-	size_t numSteps = endStep - startStep + 1;
-	
-	int step = startStep;
-	for (int i = 0; i < numSteps; i++) {
-		int distance = sixBitCharDecode(raw + (i * 3), 3);
-		distances[step] = distance;
-		step += 1;
+		int wholeValues = std::min<int>((payloadEnd - c) / 3, numberSteps - decoded);
+		for (int i = 0; i < wholeValues; i++) {
+			output[decoded + i] = sixBitCharDecode(c + i * 3, 3);
+		}
+		decoded += wholeValues;
+		c       += wholeValues * 3;
+
+		while (c < payloadEnd && partialChars < 3) {
+			partialValue = (partialValue << 6) | (*c++ - 0x30);
+			partialChars++;
+		}
 	}
-	
-	std::lock_guard<std::mutex> lock(distancesAvailableMutex);
-	newDistancesAvailable = true;
+
+	if (decoded < numberSteps) return;
+
+	publishDistances();
 }
 
 void Hokuyo::parseDistancesAndIntensities(vector<string> packet) {
@@ -375,7 +421,6 @@ void Hokuyo::parseDistancesAndIntensities(vector<string> packet) {
 	 int distance = sixBitCharDecode(distanceChars);
 	 int intensity = sixBitCharDecode(intensityChars);
 	 
-	 createCoordinate(step, distance);
 	 intensities[step] = intensity;
 	 
 	 step += 1;
@@ -482,6 +527,20 @@ int Hokuyo::sixBitCharDecode(const char* data, int length) {
 	}
 }
 
+int Hokuyo::decodeDecimal(const char* data, int length) {
+	int value = 0;
+	for (int i = 0; i < length; i++) {
+		if (data[i] < '0' || data[i] > '9') return -1;
+		value = value * 10 + (data[i] - '0');
+	}
+	return value;
+}
+
+const char* Hokuyo::findLineEnd(const char* line, const char* end) {
+	const void* newline = memchr(line, '\n', end - line);
+	return newline ? static_cast<const char*>(newline) : end;
+}
+
 vector<string> Hokuyo::splitStringByNewline(const string& str) {
 	std::vector<std::string> result;
 	size_t start = 0;
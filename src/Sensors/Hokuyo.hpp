@@ -21,6 +21,10 @@ public:
 
     void threadedFunction() override;
     void checkConnection();
+
+    bool receive() override;
+    void startTimers() override;
+    void onWindowChanged(int firstStep, int lastStep) override;
     
     void sendResetStatusCommand();
     void sendSetMotorSpeedCommand(int motorSpeed);
@@ -36,28 +40,43 @@ public:
     void send(string msg);
     
     void parseResponse(const string& str);
+    void parseResponse(const char* data, size_t length);
     void parseStatusInfo(vector<string>& packet);
     void parseVersionInfo(vector<string> packet);
     void parseParameterInfo(vector<string> packet);
     void parseActivate(vector<string> packet);
     void parseQuiet(vector<string> packet);
-    void parseStreamingDistances(vector<string> packet);
-    void parseDistances(vector<string> packet);
+    void parseDistances(const char* data, size_t length);
     void parseDistancesAndIntensities(vector<string> packet);
     void parseMotorSpeed(vector<string> packet);
     
     string zeroPad(int value, int numberChars);
     string checkSum(string str, int fromEnd);
+    bool verifyCheckSum(const char* line, size_t length, int fromEnd);
     
     string formatDistanceMessage(string command);
     string formatStreamDistancesMessage(string command);
     string formatIpv4String(string command);
     
     int sixBitCharDecode(const char* data, int length);
+    int decodeDecimal(const char* data, int length);
+    const char* findLineEnd(const char* line, const char* end);
     vector<string> splitStringByNewline(const string& str);
 private:
     bool callIntensitiesActive;
-    int startStep, endStep, clusterCount, timeStamp;
+    int clusterCount, timeStamp;
+
+    // requested steps, narrowed to the filter window and read by the reactor's watchdog
+    std::atomic<int> startStep, endStep;
+
+    // the filter window as last reported, the request follows it with some slack so
+    // dragging a filter doesn't restart MD every frame
+    std::mutex stepsMutex;
+    int windowStartStep, windowEndStep;
+    std::chrono::steady_clock::time_point windowChangeTime;
+
+    void requestSteps(int firstStep, int lastStep);
+    void narrowSteps();
     
     string motorSpeed;
     string measurementMode, bitRate, sensorDiagnostic;
@@ -71,6 +90,19 @@ private:
     string status;
     float checkTimer, checkTimeInterval;
     float streamingTimer, streamingTimeInterval;
+
+    std::chrono::steady_clock::time_point lastDataTime;
+
+    static const int STATUS_INTERVAL_MS = 1000;
+    static const int DATA_TIMEOUT_MS = 3000;
+    static const int DATA_WATCHDOG_INTERVAL_MS = 1000;
+    static const int FIRST_STEP = 0;
+    static const int LAST_STEP = 1079;
+
+    // 5 degrees either side of the window, narrowed once it is 10 degrees too wide and settled
+    static const int WINDOW_MARGIN_STEPS = 20;
+    static const int WINDOW_SETTLE_MS = 500;
+    static const int WINDOW_CHECK_INTERVAL_MS = 100;
 };
 
 #endif /* Hokuyo_hpp */
@@ -3,6 +3,7 @@
 //  meatbags
 
 #include "OrbbecPulsar.hpp"
+#include "SensorReactor.hpp"
 
 OrbbecPulsar::OrbbecPulsar() : Sensor() {
 	angularResolution = int(360.0 / 0.1);
@@ -17,6 +18,7 @@ OrbbecPulsar::OrbbecPulsar() : Sensor() {
 	lidarFaultDescription = "";
 	consecutiveErrorFrames = 0;
 	consecutiveWarningFrames = 0;
+	lastBlockStartAngle = 0;
 
 	setupParameters();
 
@@ -39,174 +41,192 @@ OrbbecPulsar::OrbbecPulsar() : Sensor() {
 	currentCheckCommandIndex = 0;
 
 	commandBuffer.reserve(64);
+
+	frameReassembler.setup({ FRAME_HEADER[0], 0x01 },
+		[this](const uint8_t* data, size_t length) { return measureFrame(data, length); },
+		[this](const uint8_t* data, size_t length) { return checkFrame(data, length); });
 }
 
 OrbbecPulsar::~OrbbecPulsar() {
 	statusCommands.clear();
 	checkCommands.clear();
 
-	sendDisableDataStreamCommand();
-	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	disconnect();
+}
+
+void OrbbecPulsar::disconnect() {
+	if (reactor) reactor->detach(this);
+
+	// graceful shutdown, disable the stream while the socket is still open
+	if (isConnected) {
+		ofLogNotice("Orbbec") << "Sensor " << index << " shutting down, disabling data stream";
+		sendDisableDataStreamCommand();
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	}
+
+	Sensor::disconnect();
+	isConnected = false;
 }
 
 void OrbbecPulsar::threadedFunction() {
-	initializeVectors();
+	// only connects and runs the handshake, from here on the socket is serviced by the reactor.
+	// the reactor isn't producing while detached, so the write buffer is this thread's to clear
+	vector<float>& scan = distances.getWriteBuffer();
+	std::fill(scan.begin(), scan.end(), 0.0f);
 
 	std::this_thread::sleep_for(std::chrono::milliseconds(200));
 
 	bool tcpConnected = tcpSetup();
 	isConnected = tcpConnected;
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(300));
-
-	if (tcpConnected) {
-		// always disable data stream first to clear any stale state from
-		// a previous session that didn't shut down cleanly (e.g. flashing red)
-		ofLogNotice("Orbbec") << "Sensor " << index << " clearing stale state...";
-		sendDisableDataStreamCommand();
-		std::this_thread::sleep_for(std::chrono::milliseconds(300));
-		sendSetRangingMode();
-		std::this_thread::sleep_for(std::chrono::milliseconds(300));
-		sendConnectCommand();
+	if (!tcpConnected) {
+		ofLogNotice("Orbbec") << "Connection unsuccessful, retrying";
+		scheduleReconnect();
+		return;
 	}
 
-	// accumulation buffer for TCP stream reassembly
-	vector<uint8_t> accumBuffer;
-	accumBuffer.reserve(4096);
-
-	auto lastDataTime = std::chrono::steady_clock::now();
-	const auto timeoutDuration = std::chrono::seconds(30);
-
-	auto lastStatusTime = std::chrono::steady_clock::now();
-	const auto statusInterval = std::chrono::milliseconds(199);
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
 
-	auto lastCheckSettingTime = std::chrono::steady_clock::now();
-	const auto checkSettingInterval = std::chrono::milliseconds(200);
+	// always disable data stream first to clear any stale state from
+	// a previous session that didn't shut down cleanly (e.g. flashing red)
+	ofLogNotice("Orbbec") << "Sensor " << index << " clearing stale state...";
+	sendDisableDataStreamCommand();
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	sendSetRangingMode();
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	sendConnectCommand();
 
-	auto lastModeResetTime = std::chrono::steady_clock::now() - std::chrono::seconds(30);
-	const auto modeResetCooldown = std::chrono::seconds(5);
+	frameReassembler.clear();
 
-	auto lastReconnectionTime = std::chrono::steady_clock::now();
-	const auto reconnectionTimeout = std::chrono::milliseconds(5000);
+	lastDataTime = std::chrono::steady_clock::now();
+	lastModeResetTime = lastDataTime - std::chrono::milliseconds(MODE_RESET_COOLDOWN_MS);
 
-	while (isThreadRunning()) {
-		// read incoming bytes under mutex and append to accumulation buffer
-		int bytesRead = 0;
-		{
-			std::lock_guard<std::mutex> lock(tcpMutex);
-			isConnected = tcpClient.isConnected();
-			bytesRead = tcpClient.receiveRawBytes((char*)receiveBuffer, sizeof(receiveBuffer));
-		}
+	attachToReactor();
+}
 
-		if (bytesRead > 0) {
-			accumBuffer.insert(accumBuffer.end(), receiveBuffer, receiveBuffer + bytesRead);
-			lastDataTime = std::chrono::steady_clock::now();
-		}
+bool OrbbecPulsar::receive() {
+	// read incoming bytes straight into the reassembly buffer
+	int bytesRead;
+	{
+		std::lock_guard<std::mutex> lock(tcpMutex);
+		size_t available;
+		uint8_t* writeBuffer = frameReassembler.getWriteBuffer(available);
+		bytesRead = tcpClient.receiveRawBytes((char*)writeBuffer, (int)available);
+	}
 
-		// process all complete frames from accumulation buffer
-		while (accumBuffer.size() >= 10) {
-			if (accumBuffer[0] == 0x01 && accumBuffer[1] == 0xFE) {
-				// control response: header(2) + version(1) + dataLen(2) + controlCode(2) + responseCode(2) + data + crc(1)
-				uint16_t dataLength = (accumBuffer[3] << 8) | accumBuffer[4];
-				size_t frameSize = 10 + dataLength;
+	if (bytesRead > 0) {
+		frameReassembler.commit(bytesRead);
+		lastDataTime = std::chrono::steady_clock::now();
+	}
 
-				if (accumBuffer.size() < frameSize) break; // wait for more bytes
+	// process all complete frames in place
+	const uint8_t* frame;
+	size_t frameLength;
+	while (frameReassembler.nextFrame(frame, frameLength)) {
+		if (frame[0] == 0x01) parseControlResponse(frame, (int)frameLength);
+		else                  parsePointCloudData(frame, (int)frameLength);
+	}
 
-				parseControlResponse(accumBuffer.data(), (int)frameSize);
-				accumBuffer.erase(accumBuffer.begin(), accumBuffer.begin() + frameSize);
-			}
-			else if (accumBuffer.size() >= 8 &&
-				accumBuffer[0] == 0x4D && accumBuffer[1] == 0x53 && accumBuffer[2] == 0x02 &&
-				accumBuffer[3] == 0xF4 && accumBuffer[4] == 0xEB && accumBuffer[5] == 0x90) {
-				// point cloud: frameLength is in bytes 6-7
-				uint16_t frameLength = (accumBuffer[6] << 8) | accumBuffer[7];
+	checkErrorState();
 
-				if (accumBuffer.size() < frameLength) break; // wait for more bytes
+	std::lock_guard<std::mutex> lock(tcpMutex);
+	isConnected = tcpClient.isConnected();
+	return isConnected;
+}
 
-				parsePointCloudData(accumBuffer.data(), (int)frameLength);
-				accumBuffer.erase(accumBuffer.begin(), accumBuffer.begin() + frameLength);
-			}
-			else {
-				// unrecognized byte at front, discard and resync
-				accumBuffer.erase(accumBuffer.begin());
-			}
-		}
+void OrbbecPulsar::startTimers() {
+	reactor->addTimer(this, STATUS_INTERVAL_MS, [this]() { sendNextStatusCommand(); });
+	reactor->addTimer(this, CHECK_SETTING_INTERVAL_MS, [this]() { checkNextSetting(); });
 
+	reactor->addTimer(this, DATA_WATCHDOG_INTERVAL_MS, [this]() {
 		auto now = std::chrono::steady_clock::now();
-		if (now - lastDataTime > timeoutDuration) {
+		if (now - lastDataTime > std::chrono::milliseconds(DATA_TIMEOUT_MS)) {
 			ofLogNotice("Orbbec") << "Resending connect command";
 			sendConnectCommand();
-			lastDataTime = std::chrono::steady_clock::now();
+			lastDataTime = now;
 		}
+	});
+}
 
-		if (now - lastStatusTime > statusInterval) {
-			sendNextStatusCommand();
-			lastStatusTime = std::chrono::steady_clock::now();
-		}
+void OrbbecPulsar::checkErrorState() {
+	// react to persistent error state — standby→ranging mode reset, gated by cooldown
+	int errFrames;
+	{ std::lock_guard<std::mutex> lock(sensorDataMutex); errFrames = consecutiveErrorFrames; }
 
-		if (now - lastCheckSettingTime > checkSettingInterval) {
-			checkNextSetting();
-			lastCheckSettingTime = std::chrono::steady_clock::now();
-		}
+	auto now = std::chrono::steady_clock::now();
+	if (errFrames < ERROR_RECONNECT_THRESHOLD ||
+		now - lastModeResetTime <= std::chrono::milliseconds(MODE_RESET_COOLDOWN_MS)) return;
 
-		// react to persistent error state — standby→ranging mode reset, gated by cooldown
-		int errFrames;
-		{ std::lock_guard<std::mutex> lock(sensorDataMutex); errFrames = consecutiveErrorFrames; }
+	string fault;
+	{ std::lock_guard<std::mutex> lock(sensorDataMutex); fault = lidarFaultDescription; }
+	if (fault.empty()) fault = "unknown fault";
 
-		if (errFrames >= ERROR_RECONNECT_THRESHOLD &&
-			now - lastModeResetTime > modeResetCooldown) {
-			string fault;
-			{ std::lock_guard<std::mutex> lock(sensorDataMutex); fault = lidarFaultDescription; }
-			if (fault.empty()) fault = "unknown fault";
+	ofLogWarning("Orbbec") << "Sensor " << index
+		<< " persistent error (" << fault << ") — mode reset (standby→ranging)";
 
-			ofLogWarning("Orbbec") << "Sensor " << index
-				<< " persistent error (" << fault << ") — mode reset (standby→ranging)";
+	// reset immediately so we don't re-trigger before the cooldown expires
+	{ std::lock_guard<std::mutex> lock(sensorDataMutex); consecutiveErrorFrames = 0; }
 
-			// reset immediately so we don't re-trigger before the cooldown expires
-			{ std::lock_guard<std::mutex> lock(sensorDataMutex); consecutiveErrorFrames = 0; }
+	lastModeResetTime = now;
+	resetWorkingMode();
+}
 
-			sendSetStandbyMode();
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			sendSetRangingMode();
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			sendEnableDataStreamCommand();
-			accumBuffer.clear();
-			lastModeResetTime = std::chrono::steady_clock::now();
-		}
+void OrbbecPulsar::resetWorkingMode() {
+	// each step waits on a one-shot timer instead of sleeping, so the other sensors keep streaming
+	sendSetStandbyMode();
 
-		bool connected;
-		{
-			std::lock_guard<std::mutex> lock(tcpMutex);
-			connected = tcpClient.isConnected();
-		}
+	reactor->addTimer(this, MODE_RESET_STEP_MS, [this]() {
+		sendSetRangingMode();
+
+		reactor->addTimer(this, MODE_RESET_STEP_MS, [this]() {
+			sendEnableDataStreamCommand();
+			frameReassembler.clear();
+		}, false);
+	}, false);
+}
 
-		if (!connected) {
-			if (now - lastReconnectionTime > reconnectionTimeout) {
-				ofLogNotice("Orbbec") << "Connection lost, attempting reconnection";
+int OrbbecPulsar::measureFrame(const uint8_t* data, size_t length) {
+	if (data[0] == 0x01) {
+		// control response: header(2) + version(1) + dataLen(2) + controlCode(2) + responseCode(2) + data + crc(1)
+		if (length < 2) return 0;
+		if (data[1] != 0xFE) return -1;
+		if (length < 5) return 0;
+		return 10 + ((data[3] << 8) | data[4]);
+	}
 
-				if (tcpSetup()) {
-					ofLogNotice("Orbbec") << "Reconnection successful";
-					accumBuffer.clear(); // discard stale partial data on reconnect
-					sendConnectCommand();
-				}
-				else {
-					ofLogNotice("Orbbec") << "Reconnection unsuccessful";
-				}
+	// point cloud: 6 byte header, frameLength in bytes 6-7, resolution in 12-13, info type in 14
+	size_t headerLength = std::min(length, FRAME_HEADER.size());
+	if (memcmp(data, FRAME_HEADER.data(), headerLength) != 0) return -1;
+	if (length < 15) return 0;
 
-				lastReconnectionTime = std::chrono::steady_clock::now();
-			}
-		}
-		else {
-			lastReconnectionTime = std::chrono::steady_clock::now();
-		}
+	// a header describing a block the sensor never sends is a false match in garbage
+	int frameLength = (data[6] << 8) | data[7];
+	int pointCount = getBlockPointCount(data[14]);
+	if (pointCount == 0 || !isKnownAngularResolution((data[12] << 8) | data[13])) return -1;
+	if (frameLength < POINT_CLOUD_HEADER_LENGTH + pointCount * 4) return -1;
+	return frameLength;
+}
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+int OrbbecPulsar::getBlockPointCount(uint8_t infoType) {
+	switch (infoType) {
+	case 1: return 200;
+	case 2: return 150;
+	case 3: return 120;
+	case 4: return 100;
+	case 5: return 75;
+	default: return 0;
 	}
+}
 
-	// graceful shutdown — send disable while socket is still open
-	ofLogNotice("Orbbec") << "Sensor " << index << " shutting down, disabling data stream";
-	sendDisableDataStreamCommand();
-	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+bool OrbbecPulsar::isKnownAngularResolution(uint16_t blockResolution) {
+	return blockResolution == 75 || blockResolution == 100 || blockResolution == 125 ||
+		blockResolution == 150 || blockResolution == 200;
+}
+
+bool OrbbecPulsar::checkFrame(const uint8_t* data, size_t length) {
+	// only control responses carry a CRC, point clouds are checked against their header in measureFrame
+	if (data[0] != 0x01) return true;
+	return calculateCRC8Fast(data, length - 1) == data[length - 1];
 }
 
 bool OrbbecPulsar::isPointCloudData(const uint8_t* data, int bytesRead) {
@@ -222,7 +242,6 @@ bool OrbbecPulsar::isControlResponse(const uint8_t* data, int bytesRead) {
 }
 
 void OrbbecPulsar::update() {
-	updateDistances();
 	updateSensorInfo();
 }
 
@@ -455,10 +474,7 @@ void OrbbecPulsar::sendControlMessage(uint16_t registerAddr, std::initializer_li
 }
 
 void OrbbecPulsar::sendControlCommand(const vector<uint8_t>& command) {
-	std::lock_guard<std::mutex> lock(tcpMutex);
-	if (tcpClient.isConnected()) {
-		tcpClient.sendRawBytes((char*)command.data(), command.size());
-	}
+	sendBytes((const char*)command.data(), command.size());
 }
 
 void OrbbecPulsar::parseControlResponse(const uint8_t* data, int bytesRead) {
@@ -656,7 +672,12 @@ void OrbbecPulsar::parsePointCloudData(const uint8_t* data, int length) {
 	uint16_t endAngle = bytesToUint16(data[10], data[11]);
 	uint16_t angularRes = bytesToUint16(data[12], data[13]);
 
+	// measureFrame already refused anything else, the points must lie inside the frame
 	uint8_t infoType = data[14];
+	int pointCount = getBlockPointCount(infoType);
+	if (pointCount == 0 || !isKnownAngularResolution(angularRes)) return;
+	if (POINT_CLOUD_HEADER_LENGTH + pointCount * 4 > frameLength) return;
+
 	uint8_t blockNumber = data[15];
 	uint16_t blockSequence = bytesToUint16(data[16], data[17]);
 
@@ -698,20 +719,17 @@ void OrbbecPulsar::parsePointCloudData(const uint8_t* data, int length) {
 		currentRotationSpeed = bytesToUint16(data[33], data[34]);
 	}
 
-	int pointCount;
-	switch (infoType) {
-	case 1: pointCount = 200; break;
-	case 2: pointCount = 150; break;
-	case 3: pointCount = 120; break;
-	case 4: pointCount = 100; break;
-	case 5: pointCount = 75; break;
-	default: pointCount = 200; break;
-	}
-
-	extractPointCloudPoints(data + 40, pointCount, startAngle, angularRes * 0.001f);
+	extractPointCloudPoints(data + POINT_CLOUD_HEADER_LENGTH, pointCount, startAngle, angularRes * 0.001f);
 }
 
 void OrbbecPulsar::extractPointCloudPoints(const uint8_t* data, int pointCount, int startAngle, float angularRes) {
+	// a block starting behind the previous one means the last revolution is complete
+	if (startAngle < lastBlockStartAngle) publishDistances();
+	lastBlockStartAngle = startAngle;
+
+	int numberSteps = round(360.0 / angularRes);
+	vector<float>& scan = getScanBuffer(numberSteps);
+
 	for (int i = 0; i < pointCount; i++) {
 		int dataIndex = i * 4;
 
@@ -721,24 +739,14 @@ void OrbbecPulsar::extractPointCloudPoints(const uint8_t* data, int pointCount,
 		uint16_t intensity = bytesToUint16(data[dataIndex + 2], data[dataIndex + 3]);
 		float pointAngle = (startAngle * 0.01f) + (i * angularRes);
 
-		int newAngularResolution = round(360.0 / angularRes);
-		if (newAngularResolution != angularResolution) {
-			angularResolution = newAngularResolution;
-			initializeVectors();
-		}
-
-		int coordIndex = (int)((pointAngle - 45.0f) / 360.0f * angularResolution);
+		int coordIndex = (int)((pointAngle - 45.0f) / 360.0f * numberSteps);
 
-		if (coordIndex >= 0 && coordIndex < angularResolution) {
+		if (coordIndex >= 0 && coordIndex < numberSteps) {
 			if (distance >= 0) {
-				std::lock_guard<std::mutex> lock(distancesMutex);
-				distances[coordIndex] = distance;
+				scan[coordIndex] = distance;
 			}
 		}
 	}
-
-	std::lock_guard<std::mutex> lock(distancesAvailableMutex);
-	newDistancesAvailable = true;
 }
 
 uint8_t OrbbecPulsar::calculateCRC8(const vector<uint8_t>& data) {
@@ -9,6 +9,7 @@
 #include "sstream"
 #include "ofxNetwork.h"
 #include "Sensor.hpp"
+#include "FrameReassembler.hpp"
 
 class OrbbecPulsar : public Sensor {
 public:
@@ -18,10 +19,26 @@ public:
     virtual void update() override;
 
     void threadedFunction() override;
+    void disconnect() override;
+
+    // the framing frameReassembler runs on, usable without a connection
+    int  measureFrame(const uint8_t* data, size_t length);
+    bool checkFrame(const uint8_t* data, size_t length);
 
 private:
-    uint8_t receiveBuffer[65536];
+    FrameReassembler frameReassembler;
     mutable string lineBuffer;
+
+    // points per point cloud block for an info type, 0 for a type the SL450 doesn't send
+    static int getBlockPointCount(uint8_t infoType);
+
+    // block angular resolutions in 0.001 degrees, one per motor speed
+    static bool isKnownAngularResolution(uint16_t blockResolution);
+
+    bool receive() override;
+    void startTimers() override;
+    void checkErrorState();
+    void resetWorkingMode();
 protected:
     void sendControlCommand(const vector<uint8_t>& command);
 
@@ -106,6 +123,7 @@ protected:
     // static constants
     const vector<uint8_t> FRAME_HEADER = { 0x4D, 0x53, 0x02, 0xF4, 0xEB, 0x90 };
     const vector<uint8_t> FRAME_FOOTER = { 0xFE, 0xFE, 0xFE, 0xFE };
+    static const int POINT_CLOUD_HEADER_LENGTH = 40;
 
     // Orbbec-specific status
     string firmwareVersion;
@@ -124,9 +142,21 @@ protected:
     string   lidarFaultDescription;
     int      consecutiveErrorFrames;
     int      consecutiveWarningFrames;
+    int      lastBlockStartAngle;
     static const int ERROR_RECONNECT_THRESHOLD = 60;   // reconnect after N consecutive error frames
     static const int WARNING_LOG_THRESHOLD = 30;   // log warning after N consecutive warning frames
 
+    // reactor timers
+    static const int STATUS_INTERVAL_MS = 199;
+    static const int CHECK_SETTING_INTERVAL_MS = 200;
+    static const int DATA_TIMEOUT_MS = 30000;
+    static const int DATA_WATCHDOG_INTERVAL_MS = 1000;
+    static const int MODE_RESET_COOLDOWN_MS = 5000;
+    static const int MODE_RESET_STEP_MS = 500;
+
+    std::chrono::steady_clock::time_point lastDataTime;
+    std::chrono::steady_clock::time_point lastModeResetTime;
+
     static std::string faultCodeToString(uint16_t code);
 
     void updateSensorInfo();
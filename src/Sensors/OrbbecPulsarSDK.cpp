@@ -43,10 +43,7 @@ void OrbbecPulsarSDK::onMotorSpeedChanged(int& hz) {
 		ofLogNotice("OrbbecSDK") << "Sensor " << index << " motor speed changed to " << hz << " Hz, restarting pipeline";
 		stopPipeline();
 	}
-	// Initialize vectors to the correct size for the new speed before pipeline restarts
-	// threadedFunction will call startPipeline() which expects vectors already sized correctly
-	angularResolution = scanRateToPointCount(hzToScanRate(hz));
-	initializeVectors();
+	// the scans at the new speed resize the buffers as they arrive
 }
 
 void OrbbecPulsarSDK::onFilterLevelChanged(int& level) {
@@ -87,6 +84,7 @@ void OrbbecPulsarSDK::setMirrorAngles(bool& mirror) {
 			float t   = base + (float)i * stepRad;
 			angles[i] = mirrorAngles ? -(t + HALF_PI) : (t - HALF_PI);
 		}
+		updateUnitVectors();
 	}
 }
 
@@ -102,10 +100,11 @@ void OrbbecPulsarSDK::initializeVectors() {
 		float t   = base + (float)i * stepRad;
 		angles[i] = mirrorAngles ? -(t + HALF_PI) : (t - HALF_PI);
 	}
+
+	updateUnitVectors();
 }
 
 void OrbbecPulsarSDK::update() {
-	updateDistances();
 }
 
 // -----------------------------------------------------------------------------
@@ -231,14 +230,11 @@ void OrbbecPulsarSDK::startPipeline() {
 		config->enableStream(profile);
 		config->setFrameAggregateOutputMode(OB_FRAME_AGGREGATE_OUTPUT_ALL_TYPE_FRAME_REQUIRE);
 
-		// Always initialize vectors from the actual selected profile before the callback starts
-		// Safe here — pipeline not yet running, no callback thread active
+		// onFrame sizes the scan to what the profile delivers, the tracking thread follows
 		auto lidarProfile = profile->as<ob::LiDARStreamProfile>();
-		angularResolution = scanRateToPointCount(lidarProfile->getScanRate());
-		initializeVectors();
 
 		ofLogNotice("OrbbecSDK") << "Sensor " << index << " starting pipeline — "
-			<< angularResolution << " pts/rotation @ " << guiMotorSpeed.get() << " Hz";
+			<< scanRateToPointCount(lidarProfile->getScanRate()) << " pts/rotation @ " << guiMotorSpeed.get() << " Hz";
 
 		// Start with callback
 		obPipeline->start(config, [this](std::shared_ptr<ob::FrameSet> frameSet) {
@@ -249,15 +245,8 @@ void OrbbecPulsarSDK::startPipeline() {
 		isConnected      = true;
 		connectionStatus = "Connected (" + std::string(info->getName()) + " fw:" + firmwareVersion + ")";
 
-		// Note: do NOT call initializeVectors() here — the constructor pre-allocates to 3600 slots
-		// which is what makes the angleOffset math work correctly in onFrame.
-		// Just log the actual profile resolution for info.
-		lidarProfile = profile->as<ob::LiDARStreamProfile>();
-		int  actualPoints = scanRateToPointCount(lidarProfile->getScanRate());
-
 		ofLogNotice("OrbbecSDK") << "Sensor " << index << " connected — "
-			<< actualPoints << " pts/rotation @ " << guiMotorSpeed.get() << " Hz"
-			<< " (angleOffset=" << (3600 - actualPoints) << ")";
+			<< scanRateToPointCount(lidarProfile->getScanRate()) << " pts/rotation @ " << guiMotorSpeed.get() << " Hz";
 	}
 	catch(ob::Error &e) {
 		ofLogError("OrbbecSDK") << "Sensor " << index << " connect error: " << e.what();
@@ -311,26 +300,14 @@ void OrbbecPulsarSDK::onFrame(std::shared_ptr<ob::FrameSet> frameSet) {
 
 	if(pointCount == 0) return;
 
-	// distances.size() is pre-set to match exactly what this profile delivers,
-	// so we write directly with no offset arithmetic
-	if((int)pointCount > (int)distances.size()) {
-		// shouldn't happen, but guard against it
-		ofLogWarning("OrbbecSDK") << "Sensor " << index << " pointCount " << pointCount
-			<< " > distances.size() " << distances.size() << " — dropping frame";
-		return;
-	}
+	// one step per point, a new profile resizes the write buffer and the rest follows
+	vector<float>& scan = getScanBuffer(pointCount);
 
-	{
-		std::lock_guard<std::mutex> lock(distancesMutex);
-		for(uint32_t i = 0; i < pointCount; i++) {
-			distances[i] = points[i].distance;  // mm
-		}
+	for(uint32_t i = 0; i < pointCount; i++) {
+		scan[i] = points[i].distance;  // mm
 	}
 
-	{
-		std::lock_guard<std::mutex> lock(distancesAvailableMutex);
-		newDistancesAvailable = true;
-	}
+	publishDistances();
 
 	lastFrameTime       = ofGetElapsedTimef();
 	lidarState          = "normal";
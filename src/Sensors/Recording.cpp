@@ -0,0 +1,344 @@
+//
+//  Recording.cpp
+//  meatbags
+
+#include "Recording.hpp"
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+Recording::Recording() {
+	angularResolution = 0;
+	port = 0;
+	model = "Recording";
+	showSensorInformation = false;
+
+	data = nullptr;
+	dataSize = 0;
+#ifdef TARGET_WIN32
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	fileDescriptor = -1;
+#endif
+
+	header = {};
+	indexData = nullptr;
+	scansEnd = 0;
+	numberScans = 0;
+	firstTimestampUs = 0;
+	lastTimestampUs = 0;
+
+	playbackSpeed.set("speed", 1.0, 0.0, 8.0);
+	isLooping.set("loop", true);
+
+	initializeVectors();
+	setupParameters();
+}
+
+Recording::~Recording() {
+	disconnect();
+	close();
+}
+
+void Recording::update() {
+	updateSensorInfo();
+}
+
+void Recording::setIPAddress(string& path) {
+	disconnect();
+	close();
+
+	if (!open(path)) {
+		connectionStatus = "No recording at " + path;
+		return;
+	}
+
+	connect();
+}
+
+void Recording::setMirrorAngles(bool& mirror) {
+	// mirroring was applied when the scans were recorded, the angles are replayed as they were
+	if (recordedAngles.size() == angles.size()) {
+		std::copy(recordedAngles.begin(), recordedAngles.end(), angles.begin());
+	}
+
+	updateUnitVectors();
+}
+
+void Recording::seek(double seconds) {
+	seekTargetUs = firstTimestampUs + (int64_t)(std::max(seconds, 0.0) * 1000000.0);
+}
+
+double Recording::getPosition() {
+	if (numberScans == 0) return 0.0;
+	return (double)(playheadUs - firstTimestampUs) / 1000000.0;
+}
+
+double Recording::getDuration() {
+	return (double)(lastTimestampUs - firstTimestampUs) / 1000000.0;
+}
+
+void Recording::threadedFunction() {
+	if (numberScans == 0) {
+		connectionStatus = "Recording is empty";
+		return;
+	}
+
+	isConnected = true;
+	connectionStatus = "Replaying " + ipAddress.get();
+
+	size_t scanIndex = 0;
+	double playhead = (double)firstTimestampUs;
+	auto lastTime = std::chrono::steady_clock::now();
+
+	// scans are stamped on the recorded timeline, anchored to the clock whenever playback
+	// jumps, so tracking sees the recorded motion whatever the playback speed
+	double anchorTime = getClockTime();
+	double anchorUs = (double)firstTimestampUs;
+
+	while (isThreadRunning()) {
+		float speed = playbackSpeed.get();
+
+		auto now = std::chrono::steady_clock::now();
+		playhead += std::chrono::duration<double, std::micro>(now - lastTime).count() * speed;
+		lastTime = now;
+
+		int64_t target = seekTargetUs.exchange(-1);
+		if (target >= 0) {
+			scanIndex = findScan(target);
+			playhead = (double)target;
+			anchorTime = getClockTime();
+			anchorUs = playhead;
+		}
+
+		if (scanIndex >= numberScans) {
+			if (!isLooping) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(MAX_SLEEP_MS));
+				continue;
+			}
+
+			scanIndex = 0;
+			playhead = (double)firstTimestampUs;
+			anchorTime = getClockTime();
+			anchorUs = playhead;
+		}
+
+		// publish everything that is due, at high speeds the pipeline sees the latest of them
+		uint64_t timestamp = getScanTimestamp(scanIndex);
+		if (timestamp <= playhead) {
+			publishScan(scanIndex, anchorTime + ((double)timestamp - anchorUs) * 1e-6);
+			playheadUs = timestamp;
+			scanIndex++;
+			continue;
+		}
+
+		// short sleeps keep seeks, speed changes and stopThread responsive
+		double sleepUs = MAX_SLEEP_MS * 1000.0;
+		if (speed > 0) sleepUs = std::min(sleepUs, (timestamp - playhead) / speed);
+		std::this_thread::sleep_for(std::chrono::microseconds((int64_t)sleepUs));
+	}
+
+	isConnected = false;
+}
+
+bool Recording::open(const string& path) {
+	if (path.empty()) return false;
+	if (!mapFile(ofToDataPath(path, true))) return false;
+
+	bool isValid = dataSize >= sizeof(header);
+	if (isValid) {
+		memcpy(&header, data, sizeof(header));
+
+		size_t anglesEnd = sizeof(header) + sizeof(float) * std::max(header.angularResolution, 0);
+		isValid = memcmp(header.magic, ScanFile::MAGIC, sizeof(header.magic)) == 0 &&
+			header.version == ScanFile::VERSION &&
+			header.angularResolution >= 0 &&
+			anglesEnd <= dataSize;
+	}
+
+	if (!isValid) {
+		ofLogWarning("Recording") << path << " is not a scan recording";
+		unmapFile();
+		return false;
+	}
+
+	ScanFile::FileFooter footer = {};
+	if (dataSize >= sizeof(header) + sizeof(footer)) {
+		memcpy(&footer, data + dataSize - sizeof(footer), sizeof(footer));
+	}
+
+	size_t anglesEnd = sizeof(header) + sizeof(float) * header.angularResolution;
+	size_t indexEnd  = footer.indexOffset + footer.numberScans * sizeof(ScanFile::IndexEntry);
+	bool hasIndex = memcmp(footer.magic, ScanFile::MAGIC, sizeof(footer.magic)) == 0 &&
+		anglesEnd <= footer.indexOffset &&
+		indexEnd + sizeof(footer) == dataSize;
+
+	if (hasIndex) {
+		indexData = data + footer.indexOffset;
+		scansEnd = footer.indexOffset;
+		numberScans = footer.numberScans;
+		rebuiltIndex.clear();
+	} else {
+		// recording never stopped cleanly, the scans written before that are still readable
+		scansEnd = ScanFile::rebuildIndex(data, dataSize, rebuiltIndex);
+		indexData = (const uint8_t*)rebuiltIndex.data();
+		numberScans = rebuiltIndex.size();
+		ofLogWarning("Recording") << path << " has no index, recovered " << numberScans << " scans from its records";
+	}
+
+	firstTimestampUs = numberScans > 0 ? getScanTimestamp(0) : 0;
+	lastTimestampUs  = numberScans > 0 ? getScanTimestamp(numberScans - 1) : 0;
+	playheadUs = firstTimestampUs;
+
+	recordedAngles.resize(header.angularResolution);
+	memcpy(recordedAngles.data(), data + sizeof(header), sizeof(float) * recordedAngles.size());
+
+	angularResolution = header.angularResolution;
+	initializeVectors();
+
+	// the recorded pose is the default, a configuration loaded afterwards takes precedence
+	positionX = header.positionX;
+	positionY = header.positionY;
+	sensorRotationDeg = header.rotationDeg;
+	mirrorAngles.setWithoutEventNotifications(header.mirror != 0);
+
+	ofLogNotice("Recording") << "Opened " << path << ", " << numberScans << " scans over " << getDuration() << " s";
+	return true;
+}
+
+void Recording::close() {
+	unmapFile();
+
+	indexData = nullptr;
+	rebuiltIndex.clear();
+	scansEnd = 0;
+	numberScans = 0;
+	firstTimestampUs = 0;
+	lastTimestampUs = 0;
+	playheadUs = 0;
+	seekTargetUs = -1;
+}
+
+bool Recording::mapFile(const string& path) {
+#ifdef TARGET_WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (view == nullptr) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = (const uint8_t*)view;
+	dataSize = (size_t)size.QuadPart;
+#else
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) return false;
+
+	struct stat fileStat;
+	if (fstat(descriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+		::close(descriptor);
+		return false;
+	}
+
+	void* view = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (view == MAP_FAILED) {
+		::close(descriptor);
+		return false;
+	}
+
+	// replay reads front to back
+	madvise(view, fileStat.st_size, MADV_SEQUENTIAL);
+
+	fileDescriptor = descriptor;
+	data = (const uint8_t*)view;
+	dataSize = (size_t)fileStat.st_size;
+#endif
+	return true;
+}
+
+void Recording::unmapFile() {
+	if (data == nullptr) return;
+
+#ifdef TARGET_WIN32
+	UnmapViewOfFile(data);
+	CloseHandle((HANDLE)mappingHandle);
+	CloseHandle((HANDLE)fileHandle);
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	munmap((void*)data, dataSize);
+	::close(fileDescriptor);
+	fileDescriptor = -1;
+#endif
+
+	data = nullptr;
+	dataSize = 0;
+}
+
+uint64_t Recording::getScanTimestamp(size_t scanIndex) {
+	ScanFile::IndexEntry entry;
+	memcpy(&entry, indexData + scanIndex * sizeof(entry), sizeof(entry));
+	return entry.timestampUs;
+}
+
+size_t Recording::findScan(uint64_t timestampUs) {
+	// first scan at or after the timestamp
+	size_t low = 0, high = numberScans;
+	while (low < high) {
+		size_t middle = (low + high) / 2;
+		if (getScanTimestamp(middle) < timestampUs) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+void Recording::publishScan(size_t scanIndex, double scanTime) {
+	ScanFile::IndexEntry entry;
+	ScanFile::ScanHeader scan;
+	memcpy(&entry, indexData + scanIndex * sizeof(entry), sizeof(entry));
+	if (entry.offset + sizeof(scan) > scansEnd) return;
+	memcpy(&scan, data + entry.offset, sizeof(scan));
+
+	vector<float>& buffer = distances.getWriteBuffer();
+	size_t numberSteps = std::min((size_t)std::max(scan.numberSteps, 0), buffer.size());
+	if (entry.offset + sizeof(scan) + numberSteps * sizeof(float) > scansEnd) return;
+
+	memcpy(buffer.data(), data + entry.offset + sizeof(scan), numberSteps * sizeof(float));
+
+	// a short scan would otherwise leave an older scan's ranges behind in the reused buffer
+	std::fill(buffer.begin() + numberSteps, buffer.end(), 0.0f);
+	publishDistances(scanTime);
+}
+
+void Recording::updateSensorInfo() {
+	logConnectionStatus = connectionStatus;
+	if (!showSensorInformation) return;
+
+	sensorInfoLines.clear();
+	sensorInfoLines.emplace_back("Model: " + model);
+	sensorInfoLines.emplace_back("File: " + ipAddress.get());
+	sensorInfoLines.emplace_back("Recorded sensor: " + ofToString(header.sensorIndex));
+	sensorInfoLines.emplace_back("Scans: " + ofToString(numberScans));
+	sensorInfoLines.emplace_back("Position: " + ofToString(getPosition(), 1) + " / " + ofToString(getDuration(), 1) + " s");
+	sensorInfoLines.emplace_back("Speed: " + ofToString(playbackSpeed.get(), 2) + "x");
+	sensorInfoLines.emplace_back("Status: " + connectionStatus);
+}
@@ -0,0 +1,70 @@
+//
+//  Recording.hpp
+//  meatbags
+
+#ifndef Recording_hpp
+#define Recording_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+#include "Sensor.hpp"
+#include "ScanFile.h"
+
+// replays a file written by ScanRecorder through the same publish/updateDistances
+// path a live sensor uses. the file is memory mapped and its address field holds
+// the path, relative to the data folder
+class Recording : public Sensor {
+public:
+	Recording();
+	~Recording();
+
+	void update() override;
+	void setIPAddress(string& path) override;
+	void setMirrorAngles(bool& mirrorAngles) override;
+
+	void seek(double seconds);
+	double getPosition();
+	double getDuration();
+
+	// 1.0 is real time, 0 pauses
+	ofParameter<float> playbackSpeed;
+	ofParameter<bool>  isLooping;
+
+private:
+	void threadedFunction() override;
+
+	bool open(const string& path);
+	void close();
+	bool mapFile(const string& path);
+	void unmapFile();
+
+	uint64_t getScanTimestamp(size_t scanIndex);
+	size_t   findScan(uint64_t timestampUs);
+	void     publishScan(size_t scanIndex, double scanTime);
+	void     updateSensorInfo();
+
+	const uint8_t* data;
+	size_t dataSize;
+#ifdef TARGET_WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+
+	ScanFile::FileHeader header;
+	vector<float> recordedAngles;
+
+	// the index is read from the mapping, or rebuilt into memory for a file without one
+	const uint8_t* indexData;
+	vector<ScanFile::IndexEntry> rebuiltIndex;
+	size_t scansEnd, numberScans;
+	uint64_t firstTimestampUs, lastTimestampUs;
+
+	std::atomic<int64_t>  seekTargetUs{ -1 };
+	std::atomic<uint64_t> playheadUs{ 0 };
+
+	static const int MAX_SLEEP_MS = 10;
+};
+
+#endif /* Recording_hpp */
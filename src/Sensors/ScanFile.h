@@ -0,0 +1,94 @@
+//
+//  ScanFile.h
+//  meatbags
+
+#ifndef ScanFile_h
+#define ScanFile_h
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// on-disk layout of a scan recording, one file per sensor, little endian:
+//
+//   FileHeader
+//   float      angles[angularResolution]      unrotated step angles as published
+//   repeated:  ScanHeader
+//              float   distances[numberSteps]    mm
+//              int32_t intensities[numberIntensities]
+//   IndexEntry index[numberScans]
+//   FileFooter
+//
+// the index and footer are written when recording stops, a file cut short without
+// them is read by walking its scan records. records are read with memcpy, so no
+// field relies on the mapping's alignment
+namespace ScanFile {
+	static const char MAGIC[8] = { 'M', 'B', 'S', 'C', 'A', 'N', '0', '1' };
+	static const uint32_t VERSION = 1;
+	static const char* const EXTENSION = ".mbscan";
+
+	struct FileHeader {
+		char     magic[8];
+		uint32_t version;
+		int32_t  sensorIndex;
+		int32_t  angularResolution;
+		float    positionX;
+		float    positionY;
+		float    rotationDeg;
+		uint8_t  mirror;
+		uint8_t  reserved[7];
+	};
+
+	struct ScanHeader {
+		uint64_t timestampUs;
+		int32_t  sensorIndex;
+		int32_t  numberSteps;
+		int32_t  numberIntensities;
+		int32_t  reserved;
+	};
+
+	struct IndexEntry {
+		uint64_t timestampUs;
+		uint64_t offset;
+	};
+
+	struct FileFooter {
+		uint64_t indexOffset;
+		uint64_t numberScans;
+		char     magic[8];
+	};
+
+	// rebuilds the index of a file that never got one, from the scan records after the
+	// angles. stops at the first record that is cut short or isn't this sensor's and
+	// returns where the last whole record ends
+	inline size_t rebuildIndex(const uint8_t* data, size_t dataSize, std::vector<IndexEntry>& index) {
+		FileHeader header;
+		index.clear();
+		if (dataSize < sizeof(header)) return 0;
+		memcpy(&header, data, sizeof(header));
+
+		uint64_t offset = sizeof(header) + sizeof(float) * (uint64_t)std::max(header.angularResolution, 0);
+		while (offset + sizeof(ScanHeader) <= dataSize) {
+			ScanHeader scan;
+			memcpy(&scan, data + offset, sizeof(scan));
+			if (scan.sensorIndex != header.sensorIndex || scan.numberSteps < 0 || scan.numberIntensities < 0) break;
+			if (!index.empty() && scan.timestampUs < index.back().timestampUs) break;
+
+			uint64_t end = offset + sizeof(scan) + sizeof(float) * (uint64_t)scan.numberSteps + sizeof(int32_t) * (uint64_t)scan.numberIntensities;
+			if (end > dataSize) break;
+
+			index.push_back({ scan.timestampUs, offset });
+			offset = end;
+		}
+
+		return std::min<uint64_t>(offset, dataSize);
+	}
+
+	static_assert(sizeof(FileHeader) == 40, "ScanFile::FileHeader layout changed");
+	static_assert(sizeof(ScanHeader) == 24, "ScanFile::ScanHeader layout changed");
+	static_assert(sizeof(IndexEntry) == 16, "ScanFile::IndexEntry layout changed");
+	static_assert(sizeof(FileFooter) == 24, "ScanFile::FileFooter layout changed");
+}
+
+#endif /* ScanFile_h */
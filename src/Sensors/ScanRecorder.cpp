@@ -0,0 +1,185 @@
+//
+//  ScanRecorder.cpp
+//  meatbags
+
+#include "ScanRecorder.hpp"
+#include "Sensor.hpp"
+
+ScanRecorder::ScanRecorder() {
+	startTime = 0;
+}
+
+ScanRecorder::~ScanRecorder() {
+	stop();
+}
+
+bool ScanRecorder::start(const vector<Sensor*>& sensors, const string& directory) {
+	stop();
+
+	tracks.clear();
+	for (Sensor* sensor : sensors) {
+		string path = directory + "/sensor_" + ofToString(sensor->index) + ScanFile::EXTENSION;
+
+		Track track;
+		if (openTrack(track, sensor, path)) tracks.push_back(std::move(track));
+	}
+
+	if (tracks.empty()) return false;
+
+	startTime = Sensor::getClockTime();
+	isActive = true;
+	startThread();
+
+	ofLogNotice("ScanRecorder") << "Recording " << tracks.size() << " sensors to " << directory;
+	return true;
+}
+
+void ScanRecorder::stop() {
+	if (!isActive) return;
+	isActive = false;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopThread();
+	}
+	queueCondition.notify_all();
+	waitForThread(false);
+
+	closeTracks();
+}
+
+bool ScanRecorder::isRecording() {
+	return isActive;
+}
+
+bool ScanRecorder::openTrack(Track& track, Sensor* sensor, const string& path) {
+	track.file = fopen(path.c_str(), "wb");
+	if (track.file == nullptr) {
+		ofLogWarning("ScanRecorder") << "Could not open " << path << " for writing";
+		return false;
+	}
+
+	ScanFile::FileHeader header = {};
+	memcpy(header.magic, ScanFile::MAGIC, sizeof(header.magic));
+	header.version = ScanFile::VERSION;
+	header.sensorIndex = sensor->index;
+	header.angularResolution = (int32_t)sensor->angles.size();
+	header.positionX = sensor->positionX;
+	header.positionY = sensor->positionY;
+	header.rotationDeg = sensor->sensorRotationDeg;
+	header.mirror = sensor->mirrorAngles ? 1 : 0;
+
+	fwrite(&header, sizeof(header), 1, track.file);
+	fwrite(sensor->angles.data(), sizeof(float), sensor->angles.size(), track.file);
+
+	track.sensorIndex = sensor->index;
+	track.offset = sizeof(header) + sizeof(float) * sensor->angles.size();
+	track.index.clear();
+	track.droppedScans = 0;
+	return true;
+}
+
+void ScanRecorder::record(Sensor* sensor, const vector<float>& distances, double scanTime) {
+	if (!isActive) return;
+
+	int trackIndex = -1;
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i].sensorIndex == sensor->index) trackIndex = i;
+	}
+	if (trackIndex < 0) return;
+
+	PendingScan scan;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (queuedScans.size() >= MAX_QUEUED_SCANS) {
+			if (tracks[trackIndex].droppedScans++ == 0) {
+				ofLogWarning("ScanRecorder") << "Writing has fallen behind, dropping scans of sensor " << sensor->index;
+			}
+			return;
+		}
+
+		if (!freeScans.empty()) {
+			scan = std::move(freeScans.back());
+			freeScans.pop_back();
+		}
+	}
+
+	// stamped with when the sensor took it rather than when the pipeline got to it, so
+	// replay keeps the sensor's own timing. a scan from just before the start counts as 0
+	scan.trackIndex = trackIndex;
+	scan.timestampUs = (uint64_t)(std::max(scanTime - startTime, 0.0) * 1000000.0);
+	scan.distances.assign(distances.begin(), distances.end());
+	scan.intensities.assign(sensor->intensities.begin(), sensor->intensities.end());
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queuedScans.push_back(std::move(scan));
+	}
+	queueCondition.notify_one();
+}
+
+void ScanRecorder::threadedFunction() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this]() { return !queuedScans.empty() || !isThreadRunning(); });
+
+			// stopped and drained
+			if (queuedScans.empty()) break;
+
+			std::swap(queuedScans, writingScans);
+		}
+
+		for (const auto& scan : writingScans) {
+			writeScan(scan);
+		}
+
+		// a recording that is never stopped cleanly keeps every scan written so far
+		for (auto& track : tracks) {
+			fflush(track.file);
+		}
+
+		std::lock_guard<std::mutex> lock(queueMutex);
+		for (auto& scan : writingScans) {
+			freeScans.push_back(std::move(scan));
+		}
+		writingScans.clear();
+	}
+}
+
+void ScanRecorder::writeScan(const PendingScan& scan) {
+	Track& track = tracks[scan.trackIndex];
+
+	ScanFile::ScanHeader header = {};
+	header.timestampUs = scan.timestampUs;
+	header.sensorIndex = track.sensorIndex;
+	header.numberSteps = (int32_t)scan.distances.size();
+	header.numberIntensities = (int32_t)scan.intensities.size();
+
+	fwrite(&header, sizeof(header), 1, track.file);
+	fwrite(scan.distances.data(), sizeof(float), scan.distances.size(), track.file);
+	fwrite(scan.intensities.data(), sizeof(int32_t), scan.intensities.size(), track.file);
+
+	track.index.push_back({ scan.timestampUs, track.offset });
+	track.offset += sizeof(header) + sizeof(float) * scan.distances.size() + sizeof(int32_t) * scan.intensities.size();
+}
+
+void ScanRecorder::closeTracks() {
+	for (auto& track : tracks) {
+		ScanFile::FileFooter footer = {};
+		footer.indexOffset = track.offset;
+		footer.numberScans = track.index.size();
+		memcpy(footer.magic, ScanFile::MAGIC, sizeof(footer.magic));
+
+		fwrite(track.index.data(), sizeof(ScanFile::IndexEntry), track.index.size(), track.file);
+		fwrite(&footer, sizeof(footer), 1, track.file);
+		fclose(track.file);
+
+		ofLogNotice("ScanRecorder") << "Recorded " << track.index.size() << " scans of sensor " << track.sensorIndex;
+		if (track.droppedScans > 0) {
+			ofLogWarning("ScanRecorder") << "Dropped " << track.droppedScans << " scans of sensor " << track.sensorIndex << ", writing fell behind";
+		}
+	}
+
+	tracks.clear();
+}
@@ -0,0 +1,66 @@
+//
+//  ScanRecorder.hpp
+//  meatbags
+
+#ifndef ScanRecorder_hpp
+#define ScanRecorder_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+#include "ScanFile.h"
+
+class Sensor;
+
+// writes every scan a sensor publishes to its own indexed file, scans are
+// copied into pooled buffers on the tracking thread and written out on the
+// recorder's thread so disk latency never stalls the pipeline
+class ScanRecorder : public ofThread {
+public:
+	ScanRecorder();
+	~ScanRecorder();
+
+	bool start(const vector<Sensor*>& sensors, const string& directory);
+	void stop();
+	bool isRecording();
+
+	// called with the scan the sensor just handed to updateDistances and when it was
+	// taken, in seconds on Sensor::getClockTime()
+	void record(Sensor* sensor, const vector<float>& distances, double scanTime);
+
+	void threadedFunction() override;
+
+private:
+	struct Track {
+		int sensorIndex;
+		FILE* file;
+		uint64_t offset;
+		vector<ScanFile::IndexEntry> index;
+
+		// counted under queueMutex, reported when the track is closed
+		uint64_t droppedScans;
+	};
+
+	struct PendingScan {
+		int trackIndex;
+		uint64_t timestampUs;
+		vector<float> distances;
+		vector<int32_t> intensities;
+	};
+
+	bool openTrack(Track& track, Sensor* sensor, const string& path);
+	void writeScan(const PendingScan& scan);
+	void closeTracks();
+
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	vector<PendingScan> queuedScans, writingScans, freeScans;
+
+	vector<Track> tracks;
+	std::atomic<bool> isActive{ false };
+	double startTime;
+
+	// scans queued beyond this are dropped rather than growing without bound
+	static const int MAX_QUEUED_SCANS = 1024;
+};
+
+#endif /* ScanRecorder_hpp */
@@ -3,6 +3,7 @@
 //  meatbags
 
 #include "Sensor.hpp"
+#include "SensorReactor.hpp"
 
 Sensor::Sensor() {
 	isConnected = false;
@@ -28,6 +29,14 @@ Sensor::Sensor() {
 	port = 0;
 
 	newCoordinatesAvailable = true;
+	reactor = nullptr;
+
+	isWindowed.set("window to filters", false);
+	windowFirstStep = 0;
+	windowLastStep = -1;
+	windowRotationRad = 0;
+	windowMirror = false;
+	windowSteps = 0;
 
 	stopThread();
 	waitForThread(true);
@@ -40,15 +49,7 @@ Sensor::~Sensor() {
 	mirrorAngles.removeListener(this, &Sensor::setMirrorAngles);
 	sensorRotationDeg.removeListener(this, &Sensor::setSensorRotation);
 
-	if (isThreadRunning()) {
-		stopThread();
-		waitForThread(true);
-	}
-
-	{
-		std::lock_guard<std::mutex> lock(tcpMutex);
-		tcpClient.close();
-	}
+	Sensor::disconnect();
 }
 
 void Sensor::update() {
@@ -75,19 +76,25 @@ void Sensor::setupParameters() {
 }
 
 void Sensor::initializeVectors() {
-	{
-		std::lock_guard<std::mutex> lock(distancesMutex);
-		distances.clear();
-		distances.resize(angularResolution);
-		std::fill(distances.begin(), distances.end(), 0.0);
-	}
-	
+	distances.reset([this](vector<float>& buffer) {
+		buffer.assign(angularResolution, 0.0);
+	});
+
+	resizeSteps(angularResolution);
+}
+
+void Sensor::resizeSteps(int numberSteps) {
+	angularResolution = numberSteps;
+
 	angles.clear();
 	angles.resize(angularResolution);
 
-	coordinates.clear();
-	coordinates.resize(angularResolution);
-	std::fill(coordinates.begin(), coordinates.end(), ofPoint::zero());
+	unitVectorsX.assign(angularResolution, 0.0);
+	unitVectorsY.assign(angularResolution, 0.0);
+
+	coordinatesX.assign(angularResolution, 0.0);
+	coordinatesY.assign(angularResolution, 0.0);
+	validCoordinates.assign(angularResolution, 0);
 
 	bool m = mirrorAngles;
 	setMirrorAngles(m);
@@ -123,31 +130,14 @@ void Sensor::drawSensorInfo() {
 }
 
 void Sensor::setIPAddress(string &ipAddress) {
-	if (isThreadRunning()) {
-		stopThread();
-		waitForThread(true);
-	}
-
-	{
-		std::lock_guard<std::mutex> lock(tcpMutex);
-		tcpClient.close();
-	}
-
+	disconnect();
 	connect();
 }
 
 void Sensor::reconnect() {
 	ofLogNotice("Sensor") << "Force reconnect on sensor " << index;
 
-	if (isThreadRunning()) {
-		stopThread();
-		waitForThread(true);
-	}
-
-	{
-		std::lock_guard<std::mutex> lock(tcpMutex);
-		tcpClient.close();
-	}
+	disconnect();
 
 	connectionStatus = "Reconnecting...";
 	isConnected = false;
@@ -169,6 +159,68 @@ void Sensor::connect() {
 	}
 }
 
+void Sensor::disconnect() {
+	if (reactor) reactor->detach(this);
+
+	if (isThreadRunning()) {
+		stopThread();
+		waitForThread(true);
+	}
+
+	// the connecting thread may have attached while it was being stopped
+	if (reactor) reactor->detach(this);
+
+	{
+		std::lock_guard<std::mutex> lock(tcpMutex);
+		tcpClient.close();
+	}
+}
+
+void Sensor::setReactor(SensorReactor* _reactor) {
+	reactor = _reactor;
+}
+
+void Sensor::attachToReactor() {
+	if (reactor) reactor->attach(this);
+}
+
+void Sensor::scheduleReconnect() {
+	if (!reactor) return;
+
+	reactor->addTimer(this, RECONNECT_INTERVAL_MS, [this]() {
+		{
+			std::lock_guard<std::mutex> lock(tcpMutex);
+			tcpClient.close();
+		}
+
+		connect();
+	}, false);
+}
+
+bool Sensor::receive() {
+	return false;
+}
+
+void Sensor::startTimers() {
+}
+
+void Sensor::sendBytes(const char* data, size_t length) {
+	if (isAttached) {
+		{
+			std::lock_guard<std::mutex> lock(writeMutex);
+			writeQueue.insert(writeQueue.end(), data, data + length);
+		}
+
+		reactor->wake();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(tcpMutex);
+	if (tcpClient.isConnected()) {
+		tcpClient.sendRawBytes(data, (int)length);
+	}
+}
+
 void Sensor::setSpace(Space& _space) {
 	space = _space;
 	scale = space.width / (space.areaSize * 1000.0);
@@ -182,6 +234,8 @@ void Sensor::setSensorRotation(float& _sensorRotationDeg) {
 	float wrapped = fmod(_sensorRotationDeg, 360.0f);
 	if (wrapped < 0.0f) wrapped += 360.0f;
 	sensorRotationRad = wrapped / 360.0f * TWO_PI;
+
+	updateUnitVectors();
 }
 
 void Sensor::setInterfaceAndIP(string _interface, string _localIP) {
@@ -202,37 +256,193 @@ void Sensor::setPositionY(float &positionY) {
 	position.y = positionY * 1000.0;
 }
 
-void Sensor::createCoordinate(int index, float distance) {
-	if (distance < 0.1) distance = 50000;
-	
-	float theta = angles[index] + sensorRotationRad;
-	
-	float x = cos(theta) * distance;
-	float y = sin(theta) * distance;
-	
-	coordinates[index].set(ofPoint(x, y) + ofPoint(position.x, position.y));
+void Sensor::updateUnitVectors() {
+	int numberSteps = std::min(angles.size(), unitVectorsX.size());
+
+	for (int i = 0; i < numberSteps; i++) {
+		float theta = angles[i] + sensorRotationRad;
+		unitVectorsX[i] = cos(theta);
+		unitVectorsY[i] = sin(theta);
+	}
 }
 
-void Sensor::updateDistances() {
-	{
-		std::lock_guard<std::mutex> lock(distancesAvailableMutex);
-		if (!newDistancesAvailable) {
-			return;
-		} else {
-			newDistancesAvailable = false;
+bool Sensor::updateDistances() {
+	if (!distances.update()) return false;
+
+	// the sensor changed its resolution, the tables follow here rather than on its thread
+	const vector<float>& scan = distances.getReadBuffer();
+	if (scan.size() != angles.size()) resizeSteps(scan.size());
+
+	int numberSteps = std::min(scan.size(), coordinatesX.size());
+
+	// plain multiply-add over separate arrays, no aliasing and no branches,
+	// so the compiler vectorizes it for SSE/AVX or NEON
+	const float* __restrict ranges = scan.data();
+	const float* __restrict cosines = unitVectorsX.data();
+	const float* __restrict sines = unitVectorsY.data();
+	float* __restrict outX = coordinatesX.data();
+	float* __restrict outY = coordinatesY.data();
+	uint8_t* __restrict isValid = validCoordinates.data();
+
+	const float originX = position.x;
+	const float originY = position.y;
+
+	for (int i = 0; i < numberSteps; i++) {
+		float distance = ranges[i];
+		outX[i] = originX + cosines[i] * distance;
+		outY[i] = originY + sines[i] * distance;
+		isValid[i] = distance > MIN_VALID_DISTANCE;
+	}
+
+	// the background learns and adapts from every return, before the window
+	// narrows them down to what the filters can see
+	background.apply(ranges, isValid, numberSteps);
+
+	std::lock_guard<std::mutex> lock(windowMutex);
+	bool isWindowActive = windowMinRanges.size() == numberSteps;
+	int firstStep = isWindowActive ? windowFirstStep : 0;
+	int lastStep = isWindowActive ? windowLastStep : numberSteps - 1;
+
+	// steps outside the window are dropped, inside it only ranges a filter can reach stay
+	std::fill(validCoordinates.begin(), validCoordinates.begin() + firstStep, 0);
+	std::fill(validCoordinates.begin() + std::max(lastStep + 1, firstStep), validCoordinates.end(), 0);
+
+	if (isWindowActive) {
+		const float* __restrict minRanges = windowMinRanges.data();
+		const float* __restrict maxRanges = windowMaxRanges.data();
+
+		for (int i = firstStep; i <= lastStep; i++) {
+			float distance = ranges[i];
+			isValid[i] &= (distance >= minRanges[i]) & (distance <= maxRanges[i]);
 		}
 	}
-	
-	{
-		std::lock_guard<std::mutex> lock(distancesMutex);
-		cachedDistances = distances;
+
+	newCoordinatesAvailable = true;
+	return true;
+}
+
+const vector<float>& Sensor::getDistances() {
+	return distances.getReadBuffer();
+}
+
+vector<float>& Sensor::getScanBuffer(int numberSteps) {
+	vector<float>& scan = distances.getWriteBuffer();
+	if (scan.size() != numberSteps) scan.assign(numberSteps, 0.0);
+	return scan;
+}
+
+void Sensor::publishDistances() {
+	publishDistances(getClockTime());
+}
+
+void Sensor::publishDistances(double scanTime) {
+	distances.publish(scanTime);
+
+	if (onDistancesAvailable) onDistancesAvailable();
+}
+
+double Sensor::getScanTime() {
+	return distances.getReadTimestamp();
+}
+
+double Sensor::getClockTime() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Sensor::updateWindow(const vector<vector<ofPoint>>& outlines, bool haveOutlinesChanged) {
+	int numberSteps = unitVectorsX.size();
+
+	if (!isWindowed) {
+		bool wasWindowed = false;
+		{
+			std::lock_guard<std::mutex> lock(windowMutex);
+			wasWindowed = !windowMinRanges.empty();
+			windowMinRanges.clear();
+			windowMaxRanges.clear();
+		}
+		if (wasWindowed) onWindowChanged(0, numberSteps - 1);
+		windowSteps = 0;
+		return;
 	}
-	
-	for (int i = 0; i < cachedDistances.size(); i++) {
-		createCoordinate(i, cachedDistances[i]);
+
+	bool hasPoseChanged = windowPosition.x != position.x || windowPosition.y != position.y || windowRotationRad != sensorRotationRad ||
+		windowMirror != mirrorAngles || windowSteps != numberSteps;
+	if (!haveOutlinesChanged && !hasPoseChanged) return;
+
+	windowPosition = position;
+	windowRotationRad = sensorRotationRad;
+	windowMirror = mirrorAngles;
+	windowSteps = numberSteps;
+
+	vector<float> minRanges(numberSteps, std::numeric_limits<float>::max());
+	vector<float> maxRanges(numberSteps, -1.0f);
+
+	for (const auto& outline : outlines) {
+		int numberVertices = outline.size();
+		if (numberVertices < 3) continue;
+
+		// crossing test, a sensor inside the outline can see it from zero range
+		bool isInside = false;
+		for (int j = 0, k = numberVertices - 1; j < numberVertices; k = j++) {
+			const ofPoint& a = outline[j];
+			const ofPoint& b = outline[k];
+			if ((a.y > position.y) != (b.y > position.y) &&
+				position.x < (b.x - a.x) * (position.y - a.y) / (b.y - a.y) + a.x) {
+				isInside = !isInside;
+			}
+		}
+
+		for (int i = 0; i < numberSteps; i++) {
+			float directionX = unitVectorsX[i];
+			float directionY = unitVectorsY[i];
+			float nearest = std::numeric_limits<float>::max();
+			float farthest = -1.0f;
+
+			// ray against every edge, t is the range along the ray and s the position along the edge
+			for (int j = 0, k = numberVertices - 1; j < numberVertices; k = j++) {
+				float edgeX = outline[j].x - outline[k].x;
+				float edgeY = outline[j].y - outline[k].y;
+				float denominator = directionX * edgeY - directionY * edgeX;
+				if (fabs(denominator) < 1e-9f) continue;
+
+				float toEdgeX = outline[k].x - position.x;
+				float toEdgeY = outline[k].y - position.y;
+				float t = (toEdgeX * edgeY - toEdgeY * edgeX) / denominator;
+				float s = (toEdgeX * directionY - toEdgeY * directionX) / denominator;
+				if (t < 0 || s < 0 || s > 1) continue;
+
+				nearest = std::min(nearest, t);
+				farthest = std::max(farthest, t);
+			}
+
+			if (farthest < 0) continue;
+			if (isInside) nearest = 0;
+
+			minRanges[i] = std::min(minRanges[i], nearest);
+			maxRanges[i] = std::max(maxRanges[i], farthest);
+		}
 	}
 
-	newCoordinatesAvailable = true;
+	int firstStep = numberSteps, lastStep = -1;
+	for (int i = 0; i < numberSteps; i++) {
+		if (maxRanges[i] < 0) continue;
+		firstStep = std::min(firstStep, i);
+		lastStep = i;
+	}
+	if (lastStep < 0) firstStep = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(windowMutex);
+		windowMinRanges.swap(minRanges);
+		windowMaxRanges.swap(maxRanges);
+		windowFirstStep = firstStep;
+		windowLastStep = lastStep;
+	}
+
+	onWindowChanged(firstStep, lastStep);
+}
+
+void Sensor::onWindowChanged(int firstStep, int lastStep) {
 }
 
 void Sensor::setMirrorAngles(bool &_mirrorAngles) {
@@ -255,6 +465,8 @@ void Sensor::setMirrorAngles(bool &_mirrorAngles) {
 		
 		angles[i] = theta + thetaOffset;
 	}
+
+	updateUnitVectors();
 }
 
 ofPoint Sensor::convertCoordinateToScreenPoint(ofPoint coordinate) {
@@ -10,6 +10,10 @@
 #include "ofxNetwork.h"
 #include "Space.h"
 #include "DraggablePoint.hpp"
+#include "TripleBuffer.hpp"
+#include "BackgroundModel.hpp"
+
+class SensorReactor;
 
 class Sensor : public ofThread {
 public:
@@ -21,7 +25,9 @@ public:
 	void draw();
 	void connect();
 	void reconnect();
+	virtual void disconnect();
 	bool tcpSetup();
+	void setReactor(SensorReactor* reactor);
 
 	void setInfoPosition(float x, float y);
 	void drawSensorInfo();
@@ -63,6 +69,7 @@ public:
 	ofParameter<float>  sensorRotationDeg;
 	ofParameter<bool>   showSensorInformation;
 	ofParameter<int>    whichMeatbag;
+	ofParameter<bool>   isWindowed;
 
 	// sensor-specific GUI params (read by SensorPanel)
 	ofParameter<int>  guiMotorSpeed;
@@ -70,9 +77,12 @@ public:
 
 	vector<string> sensorInfoLines;
 
-	void createCoordinate(int step, float distance);
 	vector<float> angles;
 
+	// rotated unit vectors per step, rebuilt only when rotation, mirroring or resolution change
+	vector<float> unitVectorsX, unitVectorsY;
+	void updateUnitVectors();
+
 	vector<int> intensities;
 	float sensorRotationRad;
 
@@ -90,26 +100,93 @@ public:
 	int   angularResolution;
 
 	std::atomic<bool> isConnected{ false };
+	std::atomic<bool> isAttached{ false };
 
+	// resets the scan buffers too, only while the sensor isn't producing and the pipeline is locked
 	virtual void initializeVectors();
 	virtual void setupParameters();
 
 	ofxTCPClient tcpClient;
 
-	void updateDistances();
-	vector<ofPoint> coordinates;
+	// takes the latest published scan, returns false when there was none
+	bool updateDistances();
+	const vector<float>& getDistances();
+
+	// world coordinates per step in mm, steps without a usable range are cleared in validCoordinates
+	vector<float> coordinatesX, coordinatesY;
+	vector<uint8_t> validCoordinates;
+
+	// static scene learned per step, its returns are cleared in validCoordinates
+	BackgroundModel background;
+
+	// while windowed, only the steps and ranges whose rays cross one of the outlines are
+	// projected. outlines are closed polygons in world mm, rebuilt when they or the pose change
+	void updateWindow(const vector<vector<ofPoint>>& outlines, bool haveOutlinesChanged);
 
 	bool newCoordinatesAvailable;
 
+	// when the scan behind the current coordinates was taken, in seconds on getClockTime()
+	double getScanTime();
+	static double getClockTime();
+
+	// invoked from the sensor's own thread whenever a complete scan is published
+	std::function<void()> onDistancesAvailable;
+
 protected:
-	vector<float> distances;
-	vector<float> cachedDistances;
+	friend class SensorReactor;
+
+	// the buffer the sensor's thread writes its next scan into. a scan of a different
+	// size resizes only this buffer, the per step tables follow in updateDistances
+	vector<float>& getScanBuffer(int numberSteps);
+
+	// stamped with the time it arrives, unless the sensor knows better
+	void publishDistances();
+	void publishDistances(double scanTime);
+
+	// the sensor's own thread only connects, then hands the socket to the reactor
+	void attachToReactor();
+	void scheduleReconnect();
+
+	// called on the reactor thread while attached, drains the socket into
+	// the parser and returns false once the connection is gone
+	virtual bool receive();
+
+	// periodic work, restarted every time the sensor is attached
+	virtual void startTimers();
+
+	// queued for the reactor while attached, sent directly while connecting
+	void sendBytes(const char* data, size_t length);
+
+	// sizes angles, unit vectors and coordinates for numberSteps, on the tracking thread
+	void resizeSteps(int numberSteps);
+
+	// lets a sensor ask its hardware for fewer steps, lastStep < firstStep when none reach a filter
+	virtual void onWindowChanged(int firstStep, int lastStep);
+
+	// written by the sensor's I/O thread, published once per complete scan
+	TripleBuffer<vector<float>> distances;
+
+	SensorReactor* reactor;
+	vector<char> writeQueue;
+	std::mutex writeMutex;
 
-	mutable std::mutex distancesMutex;
-	mutable std::mutex distancesAvailableMutex;
 	std::mutex tcpMutex;
 
-	bool newDistancesAvailable;
+	// per step range window, empty while not windowed
+	std::mutex windowMutex;
+	vector<float> windowMinRanges, windowMaxRanges;
+	int windowFirstStep, windowLastStep;
+
+	// pose the window was built for
+	ofPoint windowPosition;
+	float windowRotationRad;
+	bool windowMirror;
+	int windowSteps;
+
+	static const int RECONNECT_INTERVAL_MS = 5000;
+
+	// returns closer than this are the sensor's housing or no return at all
+	static constexpr float MIN_VALID_DISTANCE = 150.0;
 };
 
 #endif /* Sensor_hpp */
@@ -5,12 +5,16 @@
 #include "SensorManager.hpp"
 
 SensorManager::SensorManager() {
-	lidarPoints.resize(21600);
-	numberLidarPoints = 0;
+	filterGrid = nullptr;
+	lidarPointsCapacity = 0;
+	hasWarnedOverflow = false;
+	numberOverflowedPoints = 0;
 }
 
 SensorManager::~SensorManager() {
+	recorder.stop();
 	clear();
+	reactor.stop();
 }
 
 void SensorManager::setInterfaceAndIP(string interface, string IP) {
@@ -21,6 +25,7 @@ void SensorManager::setInterfaceAndIP(string interface, string IP) {
 }
 
 void SensorManager::start() {
+	reactor.start();
 	hasStarted = true;
 }
 
@@ -73,6 +78,58 @@ void SensorManager::update() {
 	}
 }
 
+void SensorManager::updateSensorWindows() {
+	// masks only ever remove points, so only the other filters bound what a sensor needs
+	vector<unsigned int> versions;
+	for (const auto& filter : filters) {
+		if (!filter->isMask) versions.push_back(filter->geometryVersion);
+	}
+
+	bool haveOutlinesChanged = versions != windowVersions;
+	if (haveOutlinesChanged) {
+		windowVersions.swap(versions);
+		windowOutlines.clear();
+
+		for (const auto& filter : filters) {
+			if (filter->isMask) continue;
+
+			vector<ofPoint> outline;
+			for (const auto& vertex : filter->polyline.getVertices()) {
+				outline.push_back(vertex * 1000.0f);
+			}
+			windowOutlines.push_back(outline);
+		}
+	}
+
+	for (auto& entry : sensorEntries) {
+		entry.sensor->updateWindow(windowOutlines, haveOutlinesChanged);
+	}
+}
+
+void SensorManager::updateDistances() {
+	bool isRecording = recorder.isRecording();
+
+	for (auto& entry : sensorEntries) {
+		bool hasNewScan = entry.sensor->updateDistances();
+		if (hasNewScan && isRecording) recorder.record(entry.sensor.get(), entry.sensor->getDistances(), entry.sensor->getScanTime());
+	}
+}
+
+void SensorManager::startRecording() {
+	string directory = ofToDataPath("recordings/" + ofGetTimestampString("%Y-%m-%d-%H-%M-%S"), true);
+	ofDirectory::createDirectory(directory, false, true);
+
+	recorder.start(getSensors(), directory);
+}
+
+void SensorManager::stopRecording() {
+	recorder.stop();
+}
+
+bool SensorManager::isRecording() {
+	return recorder.isRecording();
+}
+
 void SensorManager::clear() {
 	sensorEntries.clear();
 }
@@ -136,6 +193,7 @@ void SensorManager::changeSensorType(int index, SensorType newType) {
 	bool    savedMirror   = oldSensor->mirrorAngles;
 	int     savedMeatbag  = oldSensor->whichMeatbag;
 	bool    savedShowInfo = oldSensor->showSensorInformation;
+	bool    savedWindowed = oldSensor->isWindowed;
 	Space   savedSpace    = oldSensor->space;
 	ofPoint savedTrans    = oldSensor->translation;
 
@@ -154,6 +212,7 @@ void SensorManager::changeSensorType(int index, SensorType newType) {
 	newSensor->mirrorAngles.setWithoutEventNotifications(savedMirror);
 	newSensor->whichMeatbag           = savedMeatbag;
 	newSensor->showSensorInformation  = savedShowInfo;
+	newSensor->isWindowed             = savedWindowed;
 	newSensor->setSpace(savedSpace);
 	newSensor->setTranslation(savedTrans);
 
@@ -169,29 +228,52 @@ vector<Sensor*> SensorManager::getSensors() {
 }
 
 std::unique_ptr<Sensor> SensorManager::createSensorOfType(SensorType type) {
+	std::unique_ptr<Sensor> sensor;
 	switch (type) {
-		case SensorType::Hokuyo:          return std::make_unique<Hokuyo>();
-		case SensorType::OrbbecPulsarSDK: return std::make_unique<OrbbecPulsarSDK>();
-		default:                          return std::make_unique<OrbbecPulsarSDK>();
+		case SensorType::Hokuyo:          sensor = std::make_unique<Hokuyo>();          break;
+		case SensorType::OrbbecPulsar:    sensor = std::make_unique<OrbbecPulsar>();    break;
+		case SensorType::OrbbecPulsarSDK: sensor = std::make_unique<OrbbecPulsarSDK>(); break;
+		case SensorType::Recording:       sensor = std::make_unique<Recording>();       break;
+		case SensorType::Simulation:      sensor = std::make_unique<Simulation>();      break;
+		default:                          sensor = std::make_unique<OrbbecPulsarSDK>(); break;
 	}
+
+	// wire up before the sensor can connect and start publishing
+	sensor->setReactor(&reactor);
+	auto* simulation = dynamic_cast<Simulation*>(sensor.get());
+	if (simulation) simulation->setScene(&crowdScene);
+	sensor->onDistancesAvailable = [this]() {
+		if (onScanAvailable) onScanAvailable();
+	};
+
+	return sensor;
 }
 
 SensorType SensorManager::getCurrentSensorType(Sensor* sensor) {
 	if (dynamic_cast<Hokuyo*>(sensor))       return SensorType::Hokuyo;
+	if (dynamic_cast<OrbbecPulsar*>(sensor)) return SensorType::OrbbecPulsar;
 	if (dynamic_cast<OrbbecPulsarSDK*>(sensor)) return SensorType::OrbbecPulsarSDK;
+	if (dynamic_cast<Recording*>(sensor))    return SensorType::Recording;
+	if (dynamic_cast<Simulation*>(sensor))   return SensorType::Simulation;
 	return SensorType::OrbbecPulsarSDK;
 }
 
 SensorType SensorManager::stringToSensorType(const std::string& s) {
 	if (s == "Hokuyo")       return SensorType::Hokuyo;
 	if (s == "Orbbec Pulsar") return SensorType::OrbbecPulsarSDK;
+	if (s == "Orbbec Pulsar (TCP)") return SensorType::OrbbecPulsar;
+	if (s == "Recording")    return SensorType::Recording;
+	if (s == "Simulation")   return SensorType::Simulation;
 	return SensorType::OrbbecPulsarSDK;
 }
 
 string SensorManager::sensorTypeToString(SensorType type) {
 	switch (type) {
 		case SensorType::Hokuyo:       return "Hokuyo";
+		case SensorType::OrbbecPulsar:    return "Orbbec Pulsar (TCP)";
 		case SensorType::OrbbecPulsarSDK: return "Orbbec Pulsar";
+		case SensorType::Recording:    return "Recording";
+		case SensorType::Simulation:   return "Simulation";
 		default:                       return "Orbbec Pulsar";
 	}
 }
@@ -210,8 +292,10 @@ void SensorManager::transferSensorState(Sensor* oldSensor, Sensor* newSensor) {
 	newSensor->update();
 }
 
-void SensorManager::setFilters(const std::vector<Filter*>& filters_) {
+void SensorManager::setFilters(const std::vector<Filter*>& filters_, const FilterGrid* filterGrid_) {
 	filters = filters_;
+	filterGrid = filterGrid_;
+	updateSensorWindows();
 }
 
 void SensorManager::setSpace(Space& space) {
@@ -268,42 +352,126 @@ bool SensorManager::onKeyPressed(ofKeyEventArgs& keyArgs) {
 	return false;
 }
 
-void SensorManager::getCoordinates(const std::vector<Meatbags*>& meatbags) {
-	int overallCounter = 0;
-
+void SensorManager::updatePointCapacities(const std::vector<Meatbags*>& meatbags) {
+	// cheap enough to check every scan, and catches every way a sensor's step count changes
+	vector<int> layout;
 	for (auto& meatbag : meatbags) {
-		int inFilterCounter = 0;
+		layout.push_back(meatbag->index);
+	}
+	for (auto& entry : sensorEntries) {
+		layout.push_back(entry.sensor->whichMeatbag);
+		layout.push_back(entry.sensor->angularResolution);
+	}
+
+	if (layout == capacityLayout) return;
+	capacityLayout.swap(layout);
 
+	// at most one point per step
+	lidarPointsCapacity = 0;
+	for (auto& entry : sensorEntries) {
+		lidarPointsCapacity += std::max(entry.sensor->angularResolution, 0);
+	}
+
+	meatbagsCapacities.assign(meatbags.size(), 0);
+	for (int m = 0; m < meatbags.size(); m++) {
 		for (auto& entry : sensorEntries) {
-			if (entry.sensor->whichMeatbag != meatbag->index) continue;
-
-			for (auto& coordinate : entry.sensor->coordinates) {
-				float x = coordinate.x;
-				float y = coordinate.y;
-
-				float distance = entry.sensor->position.distance(coordinate);
-				if (distance > 150) {
-					overallCounter++;
-					lidarPoints[overallCounter].coordinate.set(x, y);
-					lidarPoints[overallCounter].color    = entry.sensor->sensorColor;
-					lidarPoints[overallCounter].isInFilter = false;
-
-					if (checkWithinFilters(x, y)) {
-						meatbag->coordinates[inFilterCounter].set(x, y);
-						inFilterCounter++;
-						lidarPoints[overallCounter].isInFilter = true;
-					}
-				}
+			if (entry.sensor->whichMeatbag != meatbags[m]->index) continue;
+			meatbagsCapacities[m] += std::max(entry.sensor->angularResolution, 0);
+		}
+	}
+
+	hasWarnedOverflow = false;
+}
+
+uint64_t SensorManager::getNumberOverflowedPoints() {
+	return numberOverflowedPoints;
+}
+
+void SensorManager::prepareCoordinates(const std::vector<Meatbags*>& meatbags) {
+	updatePointCapacities(meatbags);
+
+	// set every scan, lidarPoints is swapped with the viewer's copy after each one
+	lidarPoints.setCapacity(lidarPointsCapacity);
+	lidarPoints.clear();
+
+	meatbagsLidarPoints.resize(meatbags.size());
+	for (int m = 0; m < meatbags.size(); m++) {
+		meatbags[m]->points.setCapacity(meatbagsCapacities[m]);
+		meatbags[m]->points.clear();
+		meatbagsLidarPoints[m].setCapacity(meatbagsCapacities[m]);
+		meatbagsLidarPoints[m].clear();
+	}
+}
+
+void SensorManager::getCoordinates(int meatbagsIndex, Meatbags* meatbag) {
+	PointBuffer& points = meatbag->points;
+	PointBuffer& meatbagLidarPoints = meatbagsLidarPoints[meatbagsIndex];
+
+	points.sensors.resize(sensorEntries.size());
+	meatbag->scanTime = 0;
+
+	for (int s = 0; s < sensorEntries.size(); s++) {
+		Sensor* sensor = sensorEntries[s].sensor.get();
+		if (sensor->whichMeatbag != meatbag->index) continue;
+
+		PointBuffer::SensorOrigin& origin = points.sensors[s];
+		origin.x = sensor->position.x;
+		origin.y = sensor->position.y;
+		origin.stepAngle = sensor->angles.size() > 1 ? fabs(sensor->angles[1] - sensor->angles[0]) : 0.0f;
+		meatbag->scanTime = std::max(meatbag->scanTime, sensor->getScanTime());
+
+		const float* coordinatesX = sensor->coordinatesX.data();
+		const float* coordinatesY = sensor->coordinatesY.data();
+		const uint8_t* validCoordinates = sensor->validCoordinates.data();
+
+		int numberSteps = sensor->coordinatesX.size();
+		for (int i = 0; i < numberSteps; i++) {
+			if (!validCoordinates[i]) continue;
+
+			float x = coordinatesX[i];
+			float y = coordinatesY[i];
+
+			if (checkWithinFilters(x, y)) {
+				meatbagLidarPoints.push(x, y, s, PointBuffer::InFilter);
+				points.push(x, y, s, PointBuffer::InFilter);
+			} else {
+				meatbagLidarPoints.push(x, y, s, 0);
 			}
 		}
+	}
+}
+
+void SensorManager::finishCoordinates(const std::vector<Meatbags*>& meatbags) {
+	int numberOverflowed = 0;
+
+	// joined in Meatbags order, so the frame doesn't depend on which worker finished first
+	for (int m = 0; m < meatbags.size(); m++) {
+		const PointBuffer& meatbagLidarPoints = meatbagsLidarPoints[m];
+		for (int i = 0; i < meatbagLidarPoints.numberPoints; i++) {
+			lidarPoints.push(meatbagLidarPoints.x[i], meatbagLidarPoints.y[i],
+							 meatbagLidarPoints.sensorIndex[i], meatbagLidarPoints.flags[i]);
+		}
 
-		meatbag->numberCoordinates = inFilterCounter;
+		numberOverflowed += meatbags[m]->points.numberOverflowed + meatbagLidarPoints.numberOverflowed;
 	}
 
-	numberLidarPoints = overallCounter;
+	numberOverflowed += lidarPoints.numberOverflowed;
+	if (numberOverflowed == 0) return;
+
+	numberOverflowedPoints += numberOverflowed;
+	if (!hasWarnedOverflow) {
+		ofLogWarning("SensorManager") << "A scan had more points than its sensors' resolution, "
+			<< numberOverflowed << " points were dropped";
+		hasWarnedOverflow = true;
+	}
 }
 
 bool SensorManager::checkWithinFilters(float x, float y) {
+	// only points in cells an outline passes through need the polygon tests
+	FilterGrid::Cell cell = filterGrid ? filterGrid->lookup(x * 0.001f, y * 0.001f) : FilterGrid::Boundary;
+	if (cell == FilterGrid::Include) return true;
+	if (cell != FilterGrid::Boundary) return false;
+
 	bool isWithinFilter = false;
 	for (const auto& filter : filters) {
 		if (filter->checkInside(x * 0.001f, y * 0.001f)) {
@@ -320,6 +488,7 @@ bool SensorManager::checkWithinFilters(float x, float y) {
 
 void SensorManager::saveTo(ofJson& config) {
 	config["number_sensors"] = sensorEntries.size();
+	crowdScene.saveTo(config);
 	for (int i = 0; i < sensorEntries.size(); i++) {
 		string key  = "sensor_" + to_string(i + 1);
 		Sensor* s   = sensorEntries[i].sensor.get();
@@ -332,12 +501,18 @@ void SensorManager::saveTo(ofJson& config) {
 		config[key]["mirror"]       = s->mirrorAngles.get();
 		config[key]["which_meatbag"] = s->whichMeatbag.get();
 		config[key]["show_info"]    = s->showSensorInformation.get();
+		config[key]["window_to_filters"] = s->isWindowed.get();
 
 		// Orbbec-specific
 		config[key]["motor_speed"]  = s->guiMotorSpeed.get();
 		config[key]["fog_mode"]     = s->guiSpecialWorkingMode.get();
 		auto* sdk = dynamic_cast<OrbbecPulsarSDK*>(s);
 		if (sdk) config[key]["filter_level"] = sdk->guiFilterLevel.get();
+
+		auto* recording = dynamic_cast<Recording*>(s);
+		if (recording) config[key]["playback_speed"] = recording->playbackSpeed.get();
+
+		s->background.saveTo(config[key]);
 	}
 }
 
@@ -366,15 +541,23 @@ void SensorManager::loadSensors(int n, ofJson& config) {
 		if (sc.contains("mirror"))        s->mirrorAngles          = sc["mirror"].get<bool>();
 		if (sc.contains("which_meatbag")) s->whichMeatbag          = sc["which_meatbag"].get<int>();
 		if (sc.contains("show_info"))     s->showSensorInformation = sc["show_info"].get<bool>();
+		if (sc.contains("window_to_filters")) s->isWindowed        = sc["window_to_filters"].get<bool>();
 
 		if (sc.contains("motor_speed"))  s->guiMotorSpeed         = sc["motor_speed"].get<int>();
 		if (sc.contains("fog_mode"))     s->guiSpecialWorkingMode = sc["fog_mode"].get<bool>();
 		auto* sdk = dynamic_cast<OrbbecPulsarSDK*>(s);
 		if (sdk && sc.contains("filter_level")) sdk->guiFilterLevel = sc["filter_level"].get<int>();
+
+		auto* recording = dynamic_cast<Recording*>(s);
+		if (recording && sc.contains("playback_speed")) recording->playbackSpeed = sc["playback_speed"].get<float>();
+
+		s->background.load(sc);
 	}
 }
 
 void SensorManager::load(ofJson& config) {
+	crowdScene.load(config);
+
 	if (config.contains("number_sensors")) {
 		int n = config["number_sensors"];
 		loadSensors(n, config);
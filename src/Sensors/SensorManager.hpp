@@ -8,16 +8,26 @@
 #include <stdio.h>
 #include "ofMain.h"
 #include "Sensor.hpp"
+#include "SensorReactor.hpp"
 #include "Hokuyo.hpp"
+#include "OrbbecPulsar.hpp"
 #include "OrbbecPulsarSDK.hpp"
+#include "Recording.hpp"
+#include "Simulation.hpp"
+#include "CrowdScene.hpp"
+#include "ScanRecorder.hpp"
 #include "Space.h"
 #include "Filter.hpp"
+#include "FilterGrid.hpp"
 #include "Meatbags.hpp"
-#include "LidarPoint.h"
+#include "PointBuffer.h"
 
 enum class SensorType {
 	Hokuyo,
-	OrbbecPulsarSDK
+	OrbbecPulsar,
+	OrbbecPulsarSDK,
+	Recording,
+	Simulation
 };
 
 class SensorManager {
@@ -32,6 +42,7 @@ public:
 	~SensorManager();
 
 	void update();
+	void updateDistances();
 	void draw();
 	void updateMeatbagRange(int numMeatbags);
 	void clear();
@@ -48,12 +59,19 @@ public:
 	void removeSensor();
 	vector<Sensor*> getSensors();
 
-	void setFilters(const std::vector<Filter*>& filters);
+	void setFilters(const std::vector<Filter*>& filters, const FilterGrid* filterGrid);
 	void setSpace(Space& space);
 	void setTranslation(ofPoint translation);
 
 	bool checkWithinFilters(float x, float y);
-	void getCoordinates(const std::vector<Meatbags*>& meatbags);
+
+	// points for each Meatbags, prepare and finish run once per scan and
+	// getCoordinates once for every Meatbags, which can be on different threads
+	void prepareCoordinates(const std::vector<Meatbags*>& meatbags);
+	void getCoordinates(int meatbagsIndex, Meatbags* meatbag);
+	void finishCoordinates(const std::vector<Meatbags*>& meatbags);
+
+	void updateSensorWindows();
 
 	bool onMouseMoved(ofMouseEventArgs& mouseArgs);
 	bool onMousePressed(ofMouseEventArgs& mouseArgs);
@@ -64,12 +82,28 @@ public:
 	bool areNewCoordinatesAvailable();
 	void start();
 
+	// raw scans of every sensor to data/recordings/<timestamp>/sensor_<index>.mbscan
+	void startRecording();
+	void stopRecording();
+	bool isRecording();
+
 	SensorType stringToSensorType(const std::string& typeStr);
 
-	vector<LidarPoint> lidarPoints;
-	int numberLidarPoints;
+	// every projected point of the last scan, flagged when inside a filter
+	PointBuffer lidarPoints;
+
+	// points dropped because a buffer was full, since startup
+	uint64_t getNumberOverflowedPoints();
+
+	// fired from sensor threads when any sensor publishes a complete scan
+	std::function<void()> onScanAvailable;
 
 private:
+	// services every sensor socket, declared first so it outlives the sensors
+	SensorReactor reactor;
+	ScanRecorder recorder;
+	// walked through by every simulated sensor, outlives them like the reactor
+	CrowdScene crowdScene;
 	vector<SensorEntry> sensorEntries;
 
 	std::unique_ptr<Sensor> createSensorOfType(SensorType type);
@@ -80,6 +114,21 @@ private:
 
 	float lastFrameTime;
 	vector<Filter*> filters;
+	const FilterGrid* filterGrid;
+
+	// buffer sizes from the angular resolution of the sensors feeding them, recomputed
+	// when a sensor is added, removed, retyped, changes resolution or switches Meatbags
+	void updatePointCapacities(const std::vector<Meatbags*>& meatbags);
+	vector<int> capacityLayout;
+	vector<int> meatbagsCapacities;
+	vector<PointBuffer> meatbagsLidarPoints;
+	int lidarPointsCapacity;
+	bool hasWarnedOverflow;
+	std::atomic<uint64_t> numberOverflowedPoints;
+
+	// non-mask filter outlines in mm the sensor windows were last built from, and their versions
+	vector<vector<ofPoint>> windowOutlines;
+	vector<unsigned int> windowVersions;
 	bool hasStarted = false;
 };
 
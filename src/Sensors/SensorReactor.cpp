@@ -0,0 +1,370 @@
+//
+//  SensorReactor.cpp
+//  meatbags
+
+#include "SensorReactor.hpp"
+#include "Sensor.hpp"
+
+SensorReactor::SensorReactor() {
+	wheel.resize(WHEEL_SLOTS);
+	numberTimers = 0;
+	currentSlot = 0;
+	lastTick = std::chrono::steady_clock::now();
+
+#if defined(TARGET_LINUX)
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	// the wake handle is the only registration without a client
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.ptr = nullptr;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+	events.resize(64);
+#endif
+}
+
+SensorReactor::~SensorReactor() {
+	stop();
+
+#if defined(TARGET_LINUX)
+	::close(wakeFd);
+	::close(epollFd);
+#endif
+}
+
+void SensorReactor::start() {
+	if (isThreadRunning()) return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+		lastTick = std::chrono::steady_clock::now();
+	}
+
+	startThread();
+}
+
+void SensorReactor::stop() {
+	if (!isThreadRunning()) return;
+
+	stopThread();
+	wake();
+	waitForThread(false);
+}
+
+void SensorReactor::attach(Sensor* sensor) {
+	std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+
+	auto client = std::make_unique<Client>();
+	client->sensor = sensor;
+	client->socket = sensor->tcpClient.getSocketHandle();
+	client->sendOffset = 0;
+	client->isWaitingToWrite = false;
+	client->isDetached = false;
+
+#if defined(TARGET_LINUX)
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.ptr = client.get();
+
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, client->socket, &event) != 0) {
+		ofLogWarning("SensorReactor") << "Sensor " << sensor->index << " socket could not be registered";
+		sensor->scheduleReconnect();
+		return;
+	}
+#endif
+
+	clients.push_back(std::move(client));
+	sensor->isAttached = true;
+	sensor->startTimers();
+
+	wake();
+}
+
+void SensorReactor::detach(Sensor* sensor) {
+	std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+
+	// clients are only marked here, a wait that already returned may still
+	// point at them, the reactor thread erases them after its next pass
+	for (auto& client : clients) {
+		if (client->sensor != sensor || client->isDetached) continue;
+
+		client->isDetached = true;
+#if defined(TARGET_LINUX)
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, client->socket, nullptr);
+#endif
+	}
+
+	sensor->isAttached = false;
+	removeTimers(sensor);
+
+	{
+		std::lock_guard<std::mutex> writeLock(sensor->writeMutex);
+		sensor->writeQueue.clear();
+	}
+
+	if (!isThreadRunning()) removeDetachedClients();
+}
+
+void SensorReactor::wake() {
+	// the reactor thread flushes writes and reschedules before it waits again
+	if (isCurrentThread()) return;
+
+#if defined(TARGET_LINUX)
+	uint64_t value = 1;
+	ssize_t written = ::write(wakeFd, &value, sizeof(value));
+	(void) written;
+#endif
+}
+
+void SensorReactor::threadedFunction() {
+	while (isThreadRunning()) {
+		int timeoutMs;
+		{
+			std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+			timeoutMs = getMillisecondsUntilNextTimer();
+
+#if !defined(TARGET_LINUX)
+			pollDescriptors.clear();
+			polledClients.clear();
+
+			for (auto& client : clients) {
+				if (client->isDetached) continue;
+
+				auto& descriptor = pollDescriptors.emplace_back();
+				descriptor.fd = client->socket;
+				descriptor.events = POLLIN | (client->isWaitingToWrite ? POLLOUT : 0);
+				descriptor.revents = 0;
+				polledClients.push_back(client.get());
+			}
+#endif
+		}
+
+		waitForEvents(timeoutMs);
+
+		std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+
+		for (Client* client : readyClients) {
+			if (!client->isDetached) receive(*client);
+		}
+
+		advanceTimers();
+
+		// sends whatever the reads and timers above queued in the same pass
+		for (auto& client : clients) {
+			if (!client->isDetached) flushWrites(*client);
+		}
+
+		removeDetachedClients();
+	}
+}
+
+void SensorReactor::waitForEvents(int timeoutMs) {
+	readyClients.clear();
+
+#if defined(TARGET_LINUX)
+	int count = epoll_wait(epollFd, events.data(), (int)events.size(), timeoutMs);
+
+	for (int i = 0; i < count; i++) {
+		Client* client = (Client*)events[i].data.ptr;
+
+		if (client == nullptr) {
+			uint64_t value;
+			ssize_t bytesRead = ::read(wakeFd, &value, sizeof(value));
+			(void) bytesRead;
+			continue;
+		}
+
+		if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+			readyClients.push_back(client);
+		}
+	}
+#else
+	timeoutMs = std::min(timeoutMs, POLL_WAKE_INTERVAL_MS);
+
+	// WSAPoll rejects an empty set instead of waiting
+	if (pollDescriptors.empty()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+		return;
+	}
+
+#if defined(TARGET_WIN32)
+	int count = WSAPoll(pollDescriptors.data(), (ULONG)pollDescriptors.size(), timeoutMs);
+#else
+	int count = poll(pollDescriptors.data(), (nfds_t)pollDescriptors.size(), timeoutMs);
+#endif
+	if (count <= 0) return;
+
+	for (size_t i = 0; i < pollDescriptors.size(); i++) {
+		if (pollDescriptors[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+			readyClients.push_back(polledClients[i]);
+		}
+	}
+#endif
+}
+
+void SensorReactor::receive(Client& client) {
+	if (!client.sensor->receive()) handleDisconnect(client);
+}
+
+void SensorReactor::flushWrites(Client& client) {
+	Sensor* sensor = client.sensor;
+
+	if (client.sendOffset == client.sendBuffer.size()) {
+		client.sendBuffer.clear();
+		client.sendOffset = 0;
+
+		// swap rather than copy so both buffers keep their capacity
+		{
+			std::lock_guard<std::mutex> lock(sensor->writeMutex);
+			std::swap(client.sendBuffer, sensor->writeQueue);
+		}
+
+		if (client.sendBuffer.empty()) {
+			setWaitingToWrite(client, false);
+			return;
+		}
+	}
+
+	int bytesSent;
+	{
+		std::lock_guard<std::mutex> lock(sensor->tcpMutex);
+		const char* data = client.sendBuffer.data() + client.sendOffset;
+		bytesSent = sensor->tcpClient.sendRawBytesPartial(data, int(client.sendBuffer.size() - client.sendOffset));
+	}
+
+	if (bytesSent < 0) {
+		handleDisconnect(client);
+		return;
+	}
+
+	client.sendOffset += bytesSent;
+	setWaitingToWrite(client, client.sendOffset < client.sendBuffer.size());
+}
+
+void SensorReactor::setWaitingToWrite(Client& client, bool isWaitingToWrite) {
+	if (client.isWaitingToWrite == isWaitingToWrite) return;
+	client.isWaitingToWrite = isWaitingToWrite;
+
+#if defined(TARGET_LINUX)
+	epoll_event event = {};
+	event.events = EPOLLIN | (isWaitingToWrite ? EPOLLOUT : 0);
+	event.data.ptr = &client;
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, client.socket, &event);
+#endif
+}
+
+void SensorReactor::handleDisconnect(Client& client) {
+	if (client.isDetached) return;
+
+	Sensor* sensor = client.sensor;
+	ofLogNotice("SensorReactor") << "Sensor " << sensor->index << " connection lost, attempting reconnection";
+
+	detach(sensor);
+	sensor->isConnected = false;
+	sensor->scheduleReconnect();
+}
+
+void SensorReactor::removeDetachedClients() {
+	clients.erase(std::remove_if(clients.begin(), clients.end(),
+		[](const std::unique_ptr<Client>& client) { return client->isDetached; }),
+		clients.end());
+}
+
+void SensorReactor::addTimer(Sensor* owner, int intervalMs, TimerCallback callback, bool repeat) {
+	std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+
+	Timer timer;
+	timer.owner = owner;
+	timer.intervalTicks = std::max(1, (intervalMs + TICK_MS - 1) / TICK_MS);
+	timer.rounds = 0;
+	timer.repeat = repeat;
+	timer.isCancelled = false;
+	timer.callback = std::move(callback);
+
+	scheduleTimer(std::move(timer));
+	wake();
+}
+
+void SensorReactor::removeTimers(Sensor* owner) {
+	std::lock_guard<std::recursive_mutex> lock(reactorMutex);
+
+	for (auto& slot : wheel) {
+		size_t numberBefore = slot.size();
+		slot.erase(std::remove_if(slot.begin(), slot.end(),
+			[owner](const Timer& timer) { return timer.owner == owner; }),
+			slot.end());
+		numberTimers -= int(numberBefore - slot.size());
+	}
+
+	// timers of the slot currently firing are no longer in the wheel
+	for (auto& timer : firingTimers) {
+		if (timer.owner == owner) timer.isCancelled = true;
+	}
+}
+
+void SensorReactor::scheduleTimer(Timer timer) {
+	// a timer fires when the cursor reaches its slot with no rounds left
+	timer.rounds = (timer.intervalTicks - 1) / WHEEL_SLOTS;
+	size_t slot = (currentSlot + timer.intervalTicks) % WHEEL_SLOTS;
+
+	wheel[slot].push_back(std::move(timer));
+	numberTimers++;
+}
+
+void SensorReactor::advanceTimers() {
+	auto now = std::chrono::steady_clock::now();
+	int elapsedTicks = int(std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTick).count() / TICK_MS);
+	lastTick += std::chrono::milliseconds(elapsedTicks * TICK_MS);
+
+	for (int tick = 0; tick < elapsedTicks; tick++) {
+		currentSlot = (currentSlot + 1) % WHEEL_SLOTS;
+		if (wheel[currentSlot].empty()) continue;
+
+		// callbacks add and remove timers in the wheel, never in the list being walked
+		firingTimers.clear();
+		std::swap(firingTimers, wheel[currentSlot]);
+		numberTimers -= int(firingTimers.size());
+
+		for (size_t i = 0; i < firingTimers.size(); i++) {
+			Timer& timer = firingTimers[i];
+			if (timer.isCancelled) continue;
+
+			if (timer.rounds > 0) {
+				timer.rounds--;
+				wheel[currentSlot].push_back(std::move(timer));
+				numberTimers++;
+				continue;
+			}
+
+			timer.callback();
+
+			if (timer.repeat && !timer.isCancelled) scheduleTimer(std::move(timer));
+		}
+
+		firingTimers.clear();
+	}
+}
+
+int SensorReactor::getMillisecondsUntilNextTimer() {
+	if (numberTimers == 0) return MAX_WAIT_MS;
+
+	// timers with rounds left only need the cursor to pass, not a wake-up
+	int ticks = WHEEL_SLOTS;
+	for (int i = 1; i <= WHEEL_SLOTS; i++) {
+		const auto& slot = wheel[(currentSlot + i) % WHEEL_SLOTS];
+		bool isDue = std::any_of(slot.begin(), slot.end(),
+			[](const Timer& timer) { return timer.rounds == 0; });
+
+		if (isDue) {
+			ticks = i;
+			break;
+		}
+	}
+
+	auto sinceTick = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastTick).count();
+	int timeoutMs = ticks * TICK_MS - int(sinceTick);
+
+	return std::max(0, std::min(timeoutMs, MAX_WAIT_MS));
+}
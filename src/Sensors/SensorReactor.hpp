@@ -0,0 +1,114 @@
+//
+//  SensorReactor.hpp
+//  meatbags
+
+#ifndef SensorReactor_hpp
+#define SensorReactor_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+#include "ofxNetwork.h"
+
+#if defined(TARGET_LINUX)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif !defined(TARGET_WIN32)
+#include <poll.h>
+#endif
+
+class Sensor;
+
+// one I/O thread for every socket based sensor. sockets are waited on with
+// epoll on Linux and poll elsewhere, readable sockets are handed to the
+// sensor's receive(), queued writes are flushed as the socket accepts them
+// and periodic sensor work (status polls, watchdogs, reconnects) runs off a
+// hashed timer wheel, so an idle reactor only wakes for the next due timer
+class SensorReactor : public ofThread {
+public:
+	typedef std::function<void()> TimerCallback;
+
+	SensorReactor();
+	~SensorReactor();
+
+	void start();
+	void stop();
+
+	// hands a connected sensor's socket to the reactor, from any thread
+	void attach(Sensor* sensor);
+
+	// stops all callbacks for the sensor including its timers, once this
+	// returns the reactor no longer touches the sensor or its socket
+	void detach(Sensor* sensor);
+
+	// interrupts the wait so queued writes and new timers are picked up
+	void wake();
+
+	void addTimer(Sensor* owner, int intervalMs, TimerCallback callback, bool repeat = true);
+	void removeTimers(Sensor* owner);
+
+	void threadedFunction() override;
+
+private:
+	struct Client {
+		Sensor* sensor;
+		ofxTCPManager::SocketHandle socket;
+		vector<char> sendBuffer;
+		size_t sendOffset;
+		bool isWaitingToWrite;
+		bool isDetached;
+	};
+
+	struct Timer {
+		Sensor* owner;
+		int intervalTicks;
+		int rounds;
+		bool repeat;
+		bool isCancelled;
+		TimerCallback callback;
+	};
+
+	void waitForEvents(int timeoutMs);
+	void receive(Client& client);
+	void flushWrites(Client& client);
+	void setWaitingToWrite(Client& client, bool isWaitingToWrite);
+	void handleDisconnect(Client& client);
+	void removeDetachedClients();
+
+	void scheduleTimer(Timer timer);
+	void advanceTimers();
+	int  getMillisecondsUntilNextTimer();
+
+	// held while dispatching, recursive so sensor callbacks can queue
+	// writes, add timers or detach themselves from the reactor thread
+	std::recursive_mutex reactorMutex;
+
+	vector<std::unique_ptr<Client>> clients;
+	vector<Client*> readyClients;
+
+	vector<vector<Timer>> wheel;
+	vector<Timer> firingTimers;
+	int numberTimers;
+	size_t currentSlot;
+	std::chrono::steady_clock::time_point lastTick;
+
+#if defined(TARGET_LINUX)
+	int epollFd, wakeFd;
+	vector<epoll_event> events;
+#elif defined(TARGET_WIN32)
+	vector<WSAPOLLFD> pollDescriptors;
+	vector<Client*> polledClients;
+#else
+	vector<pollfd> pollDescriptors;
+	vector<Client*> polledClients;
+#endif
+
+	static constexpr int TICK_MS = 5;
+	static constexpr int WHEEL_SLOTS = 256;
+	static constexpr int MAX_WAIT_MS = 1000;
+
+	// poll has no portable wake-up handle, so writes queued from other
+	// threads are picked up within this interval instead
+	static constexpr int POLL_WAKE_INTERVAL_MS = 10;
+};
+
+#endif /* SensorReactor_hpp */
@@ -0,0 +1,168 @@
+//
+//  Simulation.cpp
+//  meatbags
+
+#include "Simulation.hpp"
+
+Simulation::Simulation() {
+	// same geometry as the Hokuyo, 1440 steps per turn with the front 270 degrees populated
+	angularResolution = 1440;
+	port = 0;
+	model = "Simulation";
+	showSensorInformation = false;
+
+	scene = nullptr;
+	originX = originY = 0.0;
+	baseAngle = stepAngle = 0.0;
+
+	initializeVectors();
+	setupParameters();
+}
+
+Simulation::~Simulation() {
+	disconnect();
+}
+
+void Simulation::update() {
+	// there is nothing to connect to, the scan thread runs whenever a scene is set
+	if (scene && !isThreadRunning()) {
+		random.seed(index);
+		startThread();
+	}
+
+	updateSensorInfo();
+}
+
+void Simulation::setIPAddress(string& ipAddress) {
+}
+
+void Simulation::setScene(CrowdScene* _scene) {
+	scene = _scene;
+}
+
+void Simulation::threadedFunction() {
+	isConnected = true;
+	connectionStatus = "Simulating";
+
+	auto nextScan = std::chrono::steady_clock::now();
+
+	while (isThreadRunning()) {
+		int scanRate = guiMotorSpeed.get() > 0 ? guiMotorSpeed.get() : 20;
+		auto scanInterval = std::chrono::microseconds(1000000 / scanRate);
+
+		if (!isSleeping) {
+			auto castStart = std::chrono::steady_clock::now();
+			castScan(distances.getWriteBuffer());
+			publishDistances();
+
+			castTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - castStart).count();
+			scansPublished++;
+		}
+
+		// a scan that ran long is dropped rather than bursting to catch up
+		nextScan += scanInterval;
+		auto now = std::chrono::steady_clock::now();
+		if (nextScan < now) nextScan = now;
+		std::this_thread::sleep_until(nextScan);
+	}
+
+	isConnected = false;
+}
+
+void Simulation::castScan(vector<float>& scan) {
+	int numberSteps = std::min({ (int)scan.size(), (int)unitVectorsX.size(), FIELD_OF_VIEW_STEPS });
+	ranges.assign(numberSteps, MAX_RANGE);
+
+	originX = position.x;
+	originY = position.y;
+	baseAngle = atan2(unitVectorsY[0], unitVectorsX[0]);
+	stepAngle = angles.size() > 1 ? angles[1] - angles[0] : TWO_PI / angularResolution;
+
+	auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	scene->sample(std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count(), bodies, walls);
+
+	for (const auto& body : bodies) castBody(body);
+	for (const auto& wall : walls) castWall(wall);
+
+	// no return reads as 0, like the real sensor's error codes
+	std::normal_distribution<float> noise(0.0f, RANGE_NOISE);
+	for (int i = 0; i < numberSteps; i++) {
+		scan[i] = ranges[i] < MAX_RANGE ? ranges[i] + noise(random) : 0.0f;
+	}
+	std::fill(scan.begin() + numberSteps, scan.end(), 0.0f);
+}
+
+void Simulation::stepRange(float fromAngle, float toAngle, int& firstStep, int& lastStep) {
+	// unwrapped step numbers, callers wrap them into the turn
+	float from = (fromAngle - baseAngle) / stepAngle;
+	float to = (toAngle - baseAngle) / stepAngle;
+	firstStep = (int)ceil(std::min(from, to));
+	lastStep = std::min((int)floor(std::max(from, to)), firstStep + angularResolution - 1);
+}
+
+void Simulation::castBody(const CrowdScene::Circle& body) {
+	float dx = body.x - originX;
+	float dy = body.y - originY;
+	float distanceSquared = dx * dx + dy * dy;
+	float radiusSquared = body.radius * body.radius;
+	if (distanceSquared <= radiusSquared) return;
+
+	// only the steps inside the body's angular shadow can hit it
+	float halfWidth = asin(body.radius / sqrt(distanceSquared));
+	float center = atan2(dy, dx);
+	int firstStep, lastStep;
+	stepRange(center - halfWidth, center + halfWidth, firstStep, lastStep);
+
+	int numberSteps = ranges.size();
+	for (int k = firstStep; k <= lastStep; k++) {
+		int i = ((k % angularResolution) + angularResolution) % angularResolution;
+		if (i >= numberSteps) continue;
+
+		float along = dx * unitVectorsX[i] + dy * unitVectorsY[i];
+		float discriminant = along * along - (distanceSquared - radiusSquared);
+		if (discriminant < 0) continue;
+
+		float hit = along - sqrt(discriminant);
+		if (hit > 0 && hit < ranges[i]) ranges[i] = hit;
+	}
+}
+
+void Simulation::castWall(const CrowdScene::Segment& wall) {
+	float px = wall.x1 - originX, py = wall.y1 - originY;
+	float ex = wall.x2 - wall.x1, ey = wall.y2 - wall.y1;
+
+	float startAngle = atan2(py, px);
+	float span = atan2(wall.y2 - originY, wall.x2 - originX) - startAngle;
+	if (span > PI) span -= TWO_PI;
+	if (span < -PI) span += TWO_PI;
+
+	int firstStep, lastStep;
+	stepRange(startAngle + std::min(span, 0.0f), startAngle + std::max(span, 0.0f), firstStep, lastStep);
+
+	int numberSteps = ranges.size();
+	for (int k = firstStep; k <= lastStep; k++) {
+		int i = ((k % angularResolution) + angularResolution) % angularResolution;
+		if (i >= numberSteps) continue;
+
+		float ux = unitVectorsX[i], uy = unitVectorsY[i];
+		float denominator = ux * ey - uy * ex;
+		if (fabs(denominator) < 1e-6) continue;
+
+		float hit = (px * ey - py * ex) / denominator;
+		float along = (px * uy - py * ux) / denominator;
+		if (along >= 0 && along <= 1 && hit > 0 && hit < ranges[i]) ranges[i] = hit;
+	}
+}
+
+void Simulation::updateSensorInfo() {
+	logConnectionStatus = connectionStatus;
+	if (!showSensorInformation) return;
+
+	sensorInfoLines.clear();
+	sensorInfoLines.emplace_back("Model: " + model);
+	sensorInfoLines.emplace_back("Status: " + connectionStatus);
+	sensorInfoLines.emplace_back("Scan rate: " + ofToString(guiMotorSpeed.get()) + " Hz");
+	sensorInfoLines.emplace_back("Walkers: " + ofToString(scene ? scene->numberWalkers.get() : 0));
+	sensorInfoLines.emplace_back("Cast time: " + ofToString(castTimeMs.load(), 3) + " ms");
+	sensorInfoLines.emplace_back("Scans: " + ofToString(scansPublished.load()));
+}
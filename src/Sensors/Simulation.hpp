@@ -0,0 +1,51 @@
+//
+//  Simulation.hpp
+//  meatbags
+
+#ifndef Simulation_hpp
+#define Simulation_hpp
+
+#include <stdio.h>
+#include <random>
+#include "ofMain.h"
+#include "Sensor.hpp"
+#include "CrowdScene.hpp"
+
+// a Hokuyo-like sensor that ray casts a shared CrowdScene from its own pose,
+// at the motor speed's scan rate, for load testing the pipeline without hardware
+class Simulation : public Sensor {
+public:
+	Simulation();
+	~Simulation();
+
+	void update() override;
+	void setIPAddress(string& ipAddress) override;
+	void setScene(CrowdScene* scene);
+
+	CrowdScene* scene;
+
+private:
+	void threadedFunction() override;
+	void castScan(vector<float>& scan);
+	void castBody(const CrowdScene::Circle& body);
+	void castWall(const CrowdScene::Segment& wall);
+	void stepRange(float fromAngle, float toAngle, int& firstStep, int& lastStep);
+	void updateSensorInfo();
+
+	// per scan scratch, only touched by the sensor's thread
+	vector<CrowdScene::Circle> bodies;
+	vector<CrowdScene::Segment> walls;
+	vector<float> ranges;
+	float originX, originY, baseAngle, stepAngle;
+	std::mt19937 random;
+
+	std::atomic<int> scansPublished{ 0 };
+	std::atomic<float> castTimeMs{ 0.0 };
+
+	// UST-10LX: 1081 of 1440 steps cover the front 270 degrees
+	static const int FIELD_OF_VIEW_STEPS = 1081;
+	static constexpr float MAX_RANGE = 30000.0;
+	static constexpr float RANGE_NOISE = 10.0;
+};
+
+#endif /* Simulation_hpp */
@@ -0,0 +1,70 @@
+//
+//  TripleBuffer.hpp
+//  meatbags
+
+#ifndef TripleBuffer_hpp
+#define TripleBuffer_hpp
+
+#include <atomic>
+#include <cstdint>
+
+// Single-producer / single-consumer triple buffer. The producer fills the
+// write buffer and publishes it with one atomic exchange, the consumer picks
+// up the newest complete buffer the same way, so neither side ever blocks or
+// sees a half-written scan. Each buffer carries the time it was published with.
+template <typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() {
+		writeIndex = 0;
+		readIndex  = 1;
+		state      = 2;
+	}
+
+	// producer side
+	T& getWriteBuffer() {
+		return buffers[writeIndex];
+	}
+
+	void publish(double timestamp = 0) {
+		timestamps[writeIndex] = timestamp;
+		writeIndex = state.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// consumer side, returns true when a newer buffer was swapped in
+	bool update() {
+		if (!(state.load(std::memory_order_acquire) & FRESH_BIT)) return false;
+		readIndex = state.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	const T& getReadBuffer() const {
+		return buffers[readIndex];
+	}
+
+	double getReadTimestamp() const {
+		return timestamps[readIndex];
+	}
+
+	// only safe while neither the producer nor the consumer is running
+	template <typename F>
+	void reset(F&& initialize) {
+		for (auto& buffer : buffers) initialize(buffer);
+		for (auto& timestamp : timestamps) timestamp = 0;
+		writeIndex = 0;
+		readIndex  = 1;
+		state.store(2, std::memory_order_release);
+	}
+
+private:
+	static constexpr uint8_t INDEX_MASK = 0x3;
+	static constexpr uint8_t FRESH_BIT  = 0x4;
+
+	T buffers[3];
+	double timestamps[3] = { 0, 0, 0 };
+	uint8_t writeIndex;
+	uint8_t readIndex;
+	std::atomic<uint8_t> state;
+};
+
+#endif /* TripleBuffer_hpp */
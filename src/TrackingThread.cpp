@@ -0,0 +1,143 @@
+//
+//  TrackingThread.cpp
+//  meatbags
+
+#include "TrackingThread.hpp"
+
+TrackingThread::TrackingThread() {
+	sensorManager    = nullptr;
+	filterManager    = nullptr;
+	meatbagsManager  = nullptr;
+	oscSenderManager = nullptr;
+
+	isScanAvailable = false;
+	isLidarFrameNew = false;
+}
+
+TrackingThread::~TrackingThread() {
+	stop();
+}
+
+void TrackingThread::setup(SensorManager* _sensorManager, FilterManager* _filterManager,
+						   MeatbagsManager* _meatbagsManager, OscSenderManager* _oscSenderManager) {
+	sensorManager    = _sensorManager;
+	filterManager    = _filterManager;
+	meatbagsManager  = _meatbagsManager;
+	oscSenderManager = _oscSenderManager;
+
+	sensorManager->onScanAvailable = [this]() {
+		notifyScanAvailable();
+	};
+}
+
+void TrackingThread::start() {
+	if (isThreadRunning()) return;
+
+	lastProcessTime = std::chrono::steady_clock::now();
+	workerPool.start(WorkerPool::getDefaultNumberWorkers());
+	startThread();
+}
+
+void TrackingThread::stop() {
+	if (!isThreadRunning()) return;
+
+	stopThread();
+	scanCondition.notify_one();
+	waitForThread(false);
+	workerPool.stop();
+}
+
+// called from sensor threads, must never take the pipeline mutex
+void TrackingThread::notifyScanAvailable() {
+	{
+		std::lock_guard<std::mutex> lock(scanMutex);
+		isScanAvailable = true;
+	}
+	scanCondition.notify_one();
+}
+
+std::unique_lock<std::mutex> TrackingThread::lockPipeline() {
+	return std::unique_lock<std::mutex>(pipelineMutex);
+}
+
+void TrackingThread::threadedFunction() {
+	while (isThreadRunning()) {
+		{
+			std::unique_lock<std::mutex> lock(scanMutex);
+			scanCondition.wait_for(lock, std::chrono::microseconds(IDLE_TIMEOUT_US), [this]() {
+				return isScanAvailable || !isThreadRunning();
+			});
+			isScanAvailable = false;
+		}
+
+		if (!isThreadRunning()) break;
+
+		process();
+	}
+}
+
+void TrackingThread::process() {
+	std::lock_guard<std::mutex> lock(pipelineMutex);
+
+	auto now = std::chrono::steady_clock::now();
+	float deltaTime = std::chrono::duration<float>(now - lastProcessTime).count();
+	lastProcessTime = now;
+
+	// the UI thread adds, removes and retypes filters under the same lock, so the list
+	// and grid are taken fresh here rather than from the last ofApp::update
+	sensorManager->setFilters(filterManager->getFilters(), filterManager->getFilterGrid());
+
+	meatbagsManager->update(deltaTime);
+	sensorManager->updateDistances();
+
+	bool hasNewLidarPoints = false;
+	if (sensorManager->areNewCoordinatesAvailable()) {
+		// the Meatbags share nothing, so they run side by side and join before filters and OSC
+		vector<Meatbags*> meatbags = meatbagsManager->getMeatbags();
+		sensorManager->prepareCoordinates(meatbags);
+		workerPool.run(meatbags.size(), [&](int i) {
+			meatbags[i]->workerPool = &workerPool;
+			sensorManager->getCoordinates(i, meatbags[i]);
+			meatbags[i]->updateBlobs();
+		});
+		sensorManager->finishCoordinates(meatbags);
+		hasNewLidarPoints = true;
+	}
+
+	meatbagsManager->getBlobs(blobs);
+	filterManager->checkBlobs(blobs);
+
+	oscSenderManager->send(blobs, sensorManager->getSensors(), filterManager->getFilters());
+
+	publishFrame(hasNewLidarPoints);
+}
+
+void TrackingThread::publishFrame(bool hasNewLidarPoints) {
+	std::lock_guard<std::mutex> lock(frameMutex);
+	frameBlobs = blobs;
+
+	// filter results in the same order as FilterManager::getFilters, so the
+	// viewer never reads isBlobInside while checkBlobs writes it
+	vector<Filter*> filters = filterManager->getFilters();
+	frameIsBlobInsideFilters.resize(filters.size());
+	for (int i = 0; i < filters.size(); i++) {
+		frameIsBlobInsideFilters[i] = filters[i]->isBlobInside;
+	}
+
+	if (hasNewLidarPoints) {
+		// hand the filled buffer over and let the sensor manager refill the stale one
+		std::swap(frameLidarPoints, sensorManager->lidarPoints);
+		isLidarFrameNew = true;
+	}
+}
+
+void TrackingThread::getFrame(vector<Blob>& _blobs, PointBuffer& lidarPoints, vector<bool>& isBlobInsideFilters) {
+	std::lock_guard<std::mutex> lock(frameMutex);
+	_blobs = frameBlobs;
+	isBlobInsideFilters = frameIsBlobInsideFilters;
+
+	if (!isLidarFrameNew) return;
+
+	std::swap(lidarPoints, frameLidarPoints);
+	isLidarFrameNew = false;
+}
@@ -0,0 +1,69 @@
+//
+//  TrackingThread.hpp
+//  meatbags
+
+#ifndef TrackingThread_hpp
+#define TrackingThread_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+#include "SensorManager.hpp"
+#include "FilterManager.hpp"
+#include "MeatbagsManager.hpp"
+#include "OscSenderManager.hpp"
+#include "PointBuffer.h"
+#include "WorkerPool.hpp"
+#include "Blob.hpp"
+
+// Runs clustering, matching, filtering and OSC output as soon as a sensor
+// publishes a scan instead of waiting for the next render frame. Anything that
+// mutates the managers from the main thread has to hold lockPipeline().
+class TrackingThread : public ofThread {
+public:
+	TrackingThread();
+	~TrackingThread();
+
+	void setup(SensorManager* sensorManager, FilterManager* filterManager,
+			   MeatbagsManager* meatbagsManager, OscSenderManager* oscSenderManager);
+	void start();
+	void stop();
+
+	void notifyScanAvailable();
+	std::unique_lock<std::mutex> lockPipeline();
+
+	// copies out the newest finished frame for drawing
+	void getFrame(vector<Blob>& blobs, PointBuffer& lidarPoints, vector<bool>& isBlobInsideFilters);
+
+private:
+	void threadedFunction() override;
+	void process();
+	void publishFrame(bool hasNewLidarPoints);
+
+	SensorManager*    sensorManager;
+	FilterManager*    filterManager;
+	MeatbagsManager*  meatbagsManager;
+	OscSenderManager* oscSenderManager;
+
+	// each Meatbags builds its points and clusters and matches them on its own core
+	WorkerPool workerPool;
+
+	std::mutex              pipelineMutex;
+	std::mutex              scanMutex;
+	std::condition_variable scanCondition;
+	bool                    isScanAvailable;
+
+	vector<Blob> blobs;
+	std::chrono::steady_clock::time_point lastProcessTime;
+
+	// finished frame handed to the viewer
+	std::mutex         frameMutex;
+	vector<Blob> frameBlobs;
+	vector<bool> frameIsBlobInsideFilters;
+	PointBuffer  frameLidarPoints;
+	bool         isLidarFrameNew;
+
+	// keeps blob aging and OSC output running when no scans arrive
+	static constexpr int IDLE_TIMEOUT_US = 16667;
+};
+
+#endif /* TrackingThread_hpp */
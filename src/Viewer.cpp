@@ -52,24 +52,21 @@ void Viewer::setTranslation(ofPoint _translation) {
 	translation = _translation;
 }
 
-void Viewer::draw(const vector<Blob>& blobs, const vector<Filter*>& filters, const vector<Sensor*>& sensors) {
+// sensors are drawn separately by drawSensors, which has to run under the
+// pipeline lock since the tracking thread writes their state
+void Viewer::draw(const vector<Blob>& blobs, const vector<Filter*>& filters, const vector<bool>& isBlobInsideFilters) {
 	ofPushMatrix();
 	ofTranslate(translation);
 	drawGrid();
 	drawBlobs(blobs);
-	drawFilters(filters);
-	drawSensors(sensors);
+	drawFilters(filters, isBlobInsideFilters);
 	ofPopMatrix();
 
-	for (const auto& sensor : sensors) {
-		if (sensor->showSensorInformation) sensor->draw();
-	}
-
 	drawCursorCoordinate();
 }
 
-void Viewer::drawCoordinates(vector<LidarPoint>& lidarPoints, int numberLidarPoints) {
-	initializeTrianglesMesh(lidarPoints, numberLidarPoints);
+void Viewer::drawCoordinates(const PointBuffer& lidarPoints, const vector<Sensor*>& sensors) {
+	initializeTrianglesMesh(lidarPoints, sensors);
 	ofPushMatrix();
 	ofTranslate(translation);
 	mesh.draw();
@@ -188,7 +185,8 @@ void Viewer::drawBlobs(const vector<Blob>& blobs) {
 // Point cloud mesh - indices rebuilt only when point count changes
 // -----------------------------------------------------------------------------
 
-void Viewer::initializeTrianglesMesh(const vector<LidarPoint>& lidarPoints, int numberLidarPoints) {
+void Viewer::initializeTrianglesMesh(const PointBuffer& lidarPoints, const vector<Sensor*>& sensors) {
+	int numberLidarPoints = lidarPoints.numberPoints;
 	if (numberLidarPoints != lastNumberLidarPoints) {
 		mesh.clear();
 		mesh.setMode(OF_PRIMITIVE_TRIANGLES);
@@ -215,10 +213,12 @@ void Viewer::initializeTrianglesMesh(const vector<LidarPoint>& lidarPoints, int
 	auto& colors = mesh.getColors();
 
 	for (int i = 0; i < numberLidarPoints; i++) {
-		ofColor pointColor = lidarPoints[i].color;
+		// a sensor removed since the frame was built leaves its points white for a frame
+		int sensorIndex = lidarPoints.sensorIndex[i];
+		ofColor pointColor = sensorIndex < sensors.size() ? sensors[sensorIndex]->sensorColor : ofColor::white;
 		float radius;
 
-		if (lidarPoints[i].isInFilter) {
+		if (lidarPoints.flags[i] & PointBuffer::InFilter) {
 			radius = 2.5f;
 			pointColor.a = 255;
 		} else {
@@ -226,7 +226,7 @@ void Viewer::initializeTrianglesMesh(const vector<LidarPoint>& lidarPoints, int
 			pointColor.a = 90;
 		}
 
-		ofPoint coordinate = lidarPoints[i].coordinate * scale + space.origin;
+		ofPoint coordinate = ofPoint(lidarPoints.x[i], lidarPoints.y[i]) * scale + space.origin;
 		int base = (circleResolution + 1) * i;
 
 		verts[base]  = coordinate;
@@ -253,9 +253,16 @@ void Viewer::initializeCircleMeshes() {
 // -----------------------------------------------------------------------------
 
 void Viewer::drawSensors(const vector<Sensor*>& sensors) {
+	ofPushMatrix();
+	ofTranslate(translation);
 	for (const auto& sensor : sensors) {
 		drawSensor(sensor);
 	}
+	ofPopMatrix();
+
+	for (const auto& sensor : sensors) {
+		if (sensor->showSensorInformation) sensor->draw();
+	}
 }
 
 void Viewer::rebuildConnectionStrings(const vector<Sensor*>& sensors) {
@@ -320,16 +327,18 @@ void Viewer::drawSensor(const Sensor* sensor) {
 // Filters
 // -----------------------------------------------------------------------------
 
-void Viewer::drawFilters(const vector<Filter*>& filters) {
-	for (auto& filter : filters) {
-		drawFilter(filter);
+void Viewer::drawFilters(const vector<Filter*>& filters, const vector<bool>& isBlobInsideFilters) {
+	for (int i = 0; i < filters.size(); i++) {
+		// filters added since the last tracked frame have no flag yet
+		bool isBlobInside = i < isBlobInsideFilters.size() && isBlobInsideFilters[i];
+		drawFilter(filters[i], isBlobInside);
 	}
 }
 
-void Viewer::drawFilter(Filter* filter) {
+void Viewer::drawFilter(Filter* filter, bool isBlobInside) {
 	ofColor filterColor = ofColor::magenta;
 
-	if (!filter->isBlobInside) filterColor.a = 150;
+	if (!isBlobInside)         filterColor.a = 150;
 	if (filter->isMask)        filterColor = ofColor::lightPink;
 	if (!filter->isActive)     filterColor.lerp(ofColor::grey, 0.95);
 
@@ -342,7 +351,7 @@ void Viewer::drawFilter(Filter* filter) {
 	ofFill();
 	if (filter->isMask) filter->drawShape();
 
-	drawDraggablePoints(filter);
+	drawDraggablePoints(filter, isBlobInside);
 }
 
 void Viewer::drawDraggablePoints(const Filter& bounds) {
@@ -378,9 +387,9 @@ void Viewer::drawDraggablePoints(const Filter& bounds) {
 	}
 }
 
-void Viewer::drawDraggablePoints(const Filter* filter) {
+void Viewer::drawDraggablePoints(const Filter* filter, bool isBlobInside) {
 	ofColor filterColor = ofColor::magenta;
-	if (!filter->isBlobInside) filterColor.a = 150;
+	if (!isBlobInside)         filterColor.a = 150;
 	if (filter->isMask)        filterColor = ofColor::lightPink;
 	if (!filter->isActive)     filterColor.lerp(ofColor::grey, 0.95);
 
@@ -455,20 +464,21 @@ void Viewer::drawHelpText() {
 	helpFont.draw("(f) press while over the center of a filter to toggle mask/filter", 15, 120);
 	helpFont.draw("(t) press while over the center of a filter to toggle active/inactive", 15, 140);
 	helpFont.draw("(ctrl/cmd + s) press to save", 15, 160);
+	helpFont.draw("(r) start/stop recording raw scans to data/recordings", 15, 180);
 
-	titleFont.draw("blob OSC format", 15, 200);
-	helpFont.draw("/blob index x y width length velocityX velocityY filterIndex1 filterIndex2 ...", 15, 220);
-	helpFont.draw("/blobsActive index1 index2 ...", 15, 240);
+	titleFont.draw("blob OSC format", 15, 220);
+	helpFont.draw("/blob index x y width length velocityX velocityY filterIndex1 filterIndex2 ...", 15, 240);
+	helpFont.draw("/blobsActive index1 index2 ...", 15, 260);
 
-	titleFont.draw("filter OSC format", 15, 280);
-	helpFont.draw("/filter index isAnyBlobInside blobDistanceToCentroid", 15, 300);
-	helpFont.draw("/filterBlob filterIndex blobIndex x y width height velocityX velocityY", 15, 320);
-	helpFont.draw("/filterBlobs filterIndex blobIndex1 x1 y1 blobIndex2 x2 y2 ...", 15, 340);
+	titleFont.draw("filter OSC format", 15, 300);
+	helpFont.draw("/filter index isAnyBlobInside blobDistanceToCentroid", 15, 320);
+	helpFont.draw("/filterBlob filterIndex blobIndex x y width height velocityX velocityY", 15, 340);
+	helpFont.draw("/filterBlobs filterIndex blobIndex1 x1 y1 blobIndex2 x2 y2 ...", 15, 360);
 
-	titleFont.draw("logging OSC format", 15, 380);
-	helpFont.draw("/generalStatus sensorIndex status", 15, 400);
-	helpFont.draw("/connectionStatus sensorIndex status", 15, 420);
-	helpFont.draw("/laserStatus sensorIndex status", 15, 440);
+	titleFont.draw("logging OSC format", 15, 400);
+	helpFont.draw("/generalStatus sensorIndex status", 15, 420);
+	helpFont.draw("/connectionStatus sensorIndex status", 15, 440);
+	helpFont.draw("/laserStatus sensorIndex status", 15, 460);
 }
 
 void Viewer::drawSaveNotification() {
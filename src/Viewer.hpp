@@ -13,7 +13,7 @@
 #include "Filter.hpp"
 #include "Sensor.hpp"
 #include "Space.h"
-#include "LidarPoint.h"
+#include "PointBuffer.h"
 #include "MemoryFont.hpp"
 
 class Viewer {
@@ -21,14 +21,14 @@ public:
 	Viewer();
 	~Viewer();
 	
-	void draw(const vector<Blob>& blobs, const vector<Filter*>& filters_, const vector<Sensor*>& sensors_);
+	void draw(const vector<Blob>& blobs, const vector<Filter*>& filters_, const vector<bool>& isBlobInsideFilters);
 	void drawGrid();
 	void drawDraggablePoints(const Filter& bounds);
-	void drawDraggablePoints(const Filter* filter);
-	void drawCoordinates(vector<LidarPoint>& lidarPoints, int numberLidarPoints);
+	void drawDraggablePoints(const Filter* filter, bool isBlobInside);
+	void drawCoordinates(const PointBuffer& lidarPoints, const vector<Sensor*>& sensors);
 
-	void drawFilter(Filter* filter);
-	void drawFilters(const vector<Filter*>& filters);
+	void drawFilter(Filter* filter, bool isBlobInside);
+	void drawFilters(const vector<Filter*>& filters, const vector<bool>& isBlobInsideFilters);
 	void drawSensors(const vector<Sensor*>& sensors);
 	void drawCursorCoordinate();
 	void drawHelpText();
@@ -44,7 +44,7 @@ public:
 	
 	ofMesh mesh, circleMesh;
 	void initializeCircleMeshes();
-	void initializeTrianglesMesh(const vector<LidarPoint>& lidarPoints, int numberLidarPoints);
+	void initializeTrianglesMesh(const PointBuffer& lidarPoints, const vector<Sensor*>& sensors);
 
 	Space space;
 	float scale;
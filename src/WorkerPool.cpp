@@ -0,0 +1,112 @@
+//
+//  WorkerPool.cpp
+//  meatbags
+
+#include "WorkerPool.hpp"
+
+thread_local bool WorkerPool::isInsideTask = false;
+
+WorkerPool::WorkerPool() {
+	generation = 0;
+	numberWorking = 0;
+	isStopping = false;
+	task = nullptr;
+	numberTasks = 0;
+	nextTask = 0;
+}
+
+WorkerPool::~WorkerPool() {
+	stop();
+}
+
+int WorkerPool::getDefaultNumberWorkers() {
+	return std::max((int)std::thread::hardware_concurrency() - 1, 0);
+}
+
+void WorkerPool::start(int numberWorkers) {
+	stop();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	isStopping = false;
+
+	for (int i = 0; i < numberWorkers; i++) {
+		auto worker = std::make_unique<Worker>();
+		worker->pool = this;
+		worker->lastGeneration = generation;
+		worker->startThread();
+		workers.push_back(std::move(worker));
+	}
+}
+
+void WorkerPool::stop() {
+	if (workers.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	taskCondition.notify_all();
+
+	for (auto& worker : workers) {
+		worker->waitForThread(true);
+	}
+	workers.clear();
+}
+
+int WorkerPool::getNumberWorkers() {
+	return workers.size();
+}
+
+void WorkerPool::run(int _numberTasks, const Task& _task) {
+	if (_numberTasks <= 0) return;
+
+	// nothing to share, or already on a worker, where waiting for the others could deadlock
+	if (_numberTasks == 1 || workers.empty() || isInsideTask) {
+		for (int i = 0; i < _numberTasks; i++) {
+			_task(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = &_task;
+		numberTasks = _numberTasks;
+		nextTask = 0;
+		numberWorking = workers.size();
+		generation++;
+	}
+	taskCondition.notify_all();
+
+	runTasks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	doneCondition.wait(lock, [this]() { return numberWorking == 0; });
+	task = nullptr;
+}
+
+void WorkerPool::runTasks() {
+	isInsideTask = true;
+	for (int i = nextTask++; i < numberTasks; i = nextTask++) {
+		(*task)(i);
+	}
+	isInsideTask = false;
+}
+
+void WorkerPool::Worker::threadedFunction() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(pool->mutex);
+			pool->taskCondition.wait(lock, [this]() {
+				return pool->isStopping || pool->generation != lastGeneration;
+			});
+			if (pool->isStopping) return;
+			lastGeneration = pool->generation;
+		}
+
+		pool->runTasks();
+
+		std::lock_guard<std::mutex> lock(pool->mutex);
+		if (--pool->numberWorking == 0) pool->doneCondition.notify_one();
+	}
+}
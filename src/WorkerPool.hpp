@@ -0,0 +1,60 @@
+//
+//  WorkerPool.hpp
+//  meatbags
+
+#ifndef WorkerPool_hpp
+#define WorkerPool_hpp
+
+#include <stdio.h>
+#include "ofMain.h"
+
+// a handful of threads that share the iterations of a parallel for. the thread
+// calling run() works through iterations too, and run() only returns once every
+// iteration is done, so whatever the tasks wrote is ready to read in order
+class WorkerPool {
+public:
+	typedef std::function<void(int)> Task;
+
+	WorkerPool();
+	~WorkerPool();
+
+	void start(int numberWorkers);
+	void stop();
+
+	// calls task(0) to task(numberTasks - 1), each exactly once in no particular
+	// order. a run from inside a task runs serially on that thread
+	void run(int numberTasks, const Task& task);
+
+	int getNumberWorkers();
+
+	// one less than the number of cores, the thread calling run() is the last one
+	static int getDefaultNumberWorkers();
+
+private:
+	class Worker : public ofThread {
+	public:
+		WorkerPool* pool;
+		uint64_t lastGeneration;
+		void threadedFunction() override;
+	};
+
+	void runTasks();
+
+	vector<std::unique_ptr<Worker>> workers;
+
+	std::mutex mutex;
+	std::condition_variable taskCondition;
+	std::condition_variable doneCondition;
+	uint64_t generation;
+	int numberWorking;
+	bool isStopping;
+
+	// only written while no run is in progress
+	const Task* task;
+	int numberTasks;
+	std::atomic<int> nextTask;
+
+	static thread_local bool isInsideTask;
+};
+
+#endif /* WorkerPool_hpp */
@@ -6,6 +6,7 @@ void ofApp::setup(){
 
 	setupGui();
 	setupListeners();
+	trackingThread.setup(&sensorManager, &filterManager, &meatbagsManager, &oscSenderManager);
 	loadConfiguration();
 
 	setSpace();
@@ -21,6 +22,7 @@ void ofApp::setup(){
 	}
 
 	sensorManager.start();
+	trackingThread.start();
 }
 
 void ofApp::setupGui() {
@@ -122,23 +124,19 @@ void ofApp::loadConfiguration() {
 
 //--------------------------------------------------------------
 void ofApp::update(){
-	setTranslation();
-	setSpace();
+	{
+		// tracking itself runs on trackingThread, only push UI state here
+		auto lock = trackingThread.lockPipeline();
 
-	filterManager.update();
-	sensorManager.update();
-	sensorManager.setFilters(filterManager.getFilters());
-	meatbagsManager.update();
+		setTranslation();
+		setSpace();
 
-	if (sensorManager.areNewCoordinatesAvailable()) {
-		sensorManager.getCoordinates(meatbagsManager.getMeatbags());
-		meatbagsManager.updateBlobs();
+		filterManager.update();
+		sensorManager.update();
+		sensorManager.setFilters(filterManager.getFilters(), filterManager.getFilterGrid());
 	}
 
-	meatbagsManager.getBlobs(blobs);
-	filterManager.checkBlobs(blobs);
-
-	oscSenderManager.send(blobs, sensorManager.getSensors(), filterManager.getFilters());
+	trackingThread.getFrame(blobs, lidarPoints, isBlobInsideFilters);
 }
 
 //--------------------------------------------------------------
@@ -153,9 +151,14 @@ void ofApp::draw(){
 }
 
 void ofApp::drawMeatbags() {
-	viewer.drawCoordinates(sensorManager.lidarPoints, sensorManager.numberLidarPoints);
-	viewer.draw(blobs, filterManager.getFilters(), sensorManager.getSensors());
-	sensorManager.draw();
+	viewer.drawCoordinates(lidarPoints, sensorManager.getSensors());
+	viewer.draw(blobs, filterManager.getFilters(), isBlobInsideFilters);
+	{
+		// sensor pose and connection state are written by the tracking thread
+		auto lock = trackingThread.lockPipeline();
+		viewer.drawSensors(sensorManager.getSensors());
+		sensorManager.draw();
+	}
 	buttonUI.draw();
 	// position all left-side panels dynamically below the UI box
 	int margin = 4;
@@ -184,10 +187,15 @@ void ofApp::drawSaveNotification() {
 void ofApp::drawFps() {
 	std::stringstream strm;
 	strm << std::setprecision(3) << "fps: " << ofGetFrameRate();
+
+	uint64_t numberOverflowedPoints = sensorManager.getNumberOverflowedPoints();
+	if (numberOverflowedPoints > 0) strm << "  overflowed points: " << numberOverflowedPoints;
 	ofSetWindowTitle(strm.str());
 }
 
 void ofApp::exit() {
+	trackingThread.stop();
+
 	ofRemoveListener(ofEvents().mouseMoved,    this, &ofApp::onMouseMoved);
 	ofRemoveListener(ofEvents().mousePressed,  this, &ofApp::onMousePressed);
 	ofRemoveListener(ofEvents().mouseDragged,  this, &ofApp::onMouseDragged);
@@ -253,6 +261,7 @@ void ofApp::addOscSender()       { oscSenderManager.addOscSender(); }
 void ofApp::removeOscSender()    { oscSenderManager.removeOscSender(); }
 
 void ofApp::windowResized(int width, int height) {
+	auto lock = trackingThread.lockPipeline();
 	setSpace();
 }
 
@@ -274,6 +283,7 @@ void ofApp::setSpace() {
 }
 
 void ofApp::onMouseMoved(ofMouseEventArgs& mouseArgs) {
+	auto lock = trackingThread.lockPipeline();
 	viewer.onMouseMoved(mouseArgs);
 	buttonUI.onMouseMoved(mouseArgs);
 	generalPanel.onMouseMoved(mouseArgs);
@@ -291,6 +301,7 @@ void ofApp::onMouseMoved(ofMouseEventArgs& mouseArgs) {
 }
 
 void ofApp::onMousePressed(ofMouseEventArgs& mouseArgs) {
+	auto lock = trackingThread.lockPipeline();
 	buttonUI.onMousePressed(mouseArgs);
 	if (generalPanel.onMousePressed(mouseArgs)) return;
 	if (meatbagsPanel.onMousePressed(mouseArgs, meatbagsManager.getMeatbags())) return;
@@ -305,6 +316,7 @@ void ofApp::onMousePressed(ofMouseEventArgs& mouseArgs) {
 }
 
 void ofApp::onMouseDragged(ofMouseEventArgs& mouseArgs) {
+	auto lock = trackingThread.lockPipeline();
 	viewer.onMouseMoved(mouseArgs);
 	meatbagsPanel.onMouseDragged(mouseArgs, meatbagsManager.getMeatbags());
 	sensorPanel.onMouseDragged(mouseArgs, sensorManager.getSensors());
@@ -317,6 +329,7 @@ void ofApp::onMouseDragged(ofMouseEventArgs& mouseArgs) {
 }
 
 void ofApp::onMouseReleased(ofMouseEventArgs& mouseArgs) {
+	auto lock = trackingThread.lockPipeline();
 	buttonUI.onMouseReleased(mouseArgs);
 	meatbagsPanel.onMouseReleased(mouseArgs);
 	sensorPanel.onMouseReleased(mouseArgs);
@@ -326,6 +339,7 @@ void ofApp::onMouseReleased(ofMouseEventArgs& mouseArgs) {
 }
 
 void ofApp::onMouseScrolled(ofMouseEventArgs& mouseArgs) {
+	auto lock = trackingThread.lockPipeline();
 	if (sensorPanel.onMouseScrolled(mouseArgs, sensorManager.getSensors())) return;
 	if (filterPanel.onMouseScrolled(mouseArgs, filterManager.getFilters())) return;
 	areaSize -= mouseArgs.scrollY * 0.15;
@@ -333,6 +347,7 @@ void ofApp::onMouseScrolled(ofMouseEventArgs& mouseArgs) {
 }
 
 void ofApp::onKeyPressed(ofKeyEventArgs& keyArgs) {
+	auto lock = trackingThread.lockPipeline();
 	if (sensorPanel.onKeyPressed(keyArgs, sensorManager.getSensors())) return;
 	if (oscSenderPanel.onKeyPressed(keyArgs, oscSenderManager.getOscSenders())) return;
 	if (meatbagsPanel.onKeyPressed(keyArgs, meatbagsManager.getMeatbags())) return;
@@ -342,6 +357,11 @@ void ofApp::onKeyPressed(ofKeyEventArgs& keyArgs) {
 	if (keyArgs.key == 104) isHelpMode = !isHelpMode;
 	if ((ctrlKeyActive && keyArgs.key == 19) || keyArgs.key == 115) save();
 
+	if (keyArgs.key == 114) {
+		if (sensorManager.isRecording()) sensorManager.stopRecording();
+		else                             sensorManager.startRecording();
+	}
+
 	if (keyArgs.key == 109) {
 		float x = ofGetMouseX();
 		float y = ofGetMouseY();
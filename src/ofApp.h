@@ -7,6 +7,7 @@
 #include "FilterManager.hpp"
 #include "MeatbagsManager.hpp"
 #include "OscSenderManager.hpp"
+#include "TrackingThread.hpp"
 #include "Viewer.hpp"
 #include "GeneralPanel.hpp"
 #include "MeatbagsPanel.hpp"
@@ -66,6 +67,7 @@ public:
 	FilterManager    filterManager;
 	OscSenderManager oscSenderManager;
 	MeatbagsManager  meatbagsManager;
+	TrackingThread   trackingThread;
 
 	GeneralPanel     generalPanel;
 	MeatbagsPanel    meatbagsPanel;
@@ -74,6 +76,9 @@ public:
 	FilterPanel      filterPanel;
 
 	vector<Blob> blobs;
+	PointBuffer  lidarPoints;
+	vector<bool> isBlobInsideFilters;
+
 	Viewer       viewer;
 	UI           buttonUI;
 	Space        space;
@@ -19,6 +19,9 @@ ofxTCPClient::ofxTCPClient(){
     partialPrevMsg = "";
     messageDelimiter = "[/TCP]";
     memset(tmpBuff,  0, TCP_MAX_MSG_SIZE+1);
+
+    frameBuffer.resize(TCP_FRAME_BUFFER_SIZE);
+    resetFrameBuffer();
 }
 
 //--------------------------
@@ -69,6 +72,7 @@ bool ofxTCPClient::setup(const ofxTCPSettings & settings, string interface, stri
     port		= settings.port;
     ipAddr		= settings.address;
     connected	= true;
+    resetFrameBuffer();
     return true;
 }
 
@@ -222,6 +226,21 @@ bool ofxTCPClient::sendRawBytes(const char* rawBytes, const int numBytes){
     }
 }
 
+//--------------------------
+int ofxTCPClient::sendRawBytesPartial(const char* rawBytes, const int numBytes){
+    if( !connected ) return -1;
+    if( numBytes <= 0 ) return 0;
+    int ret = TCPClient.Send(rawBytes, numBytes);
+    int errorCode = ofxNetworkGetLastError();
+    if( ret >= 0 ) return ret;
+    if( errorCode == OFXNETWORK_ERROR(WOULDBLOCK) ) return 0;
+    ofxNetworkLogError(errorCode);
+    if( isClosingCondition(ret, errorCode) ){
+        ofLogError("ofxTCPClient") << "sendRawBytesPartial(): sending failed";
+        close();
+    }
+    return -1;
+}
 
 //this only works after you have called receive
 //--------------------------
@@ -284,6 +303,77 @@ string ofxTCPClient::receive(){
     return "";
 }
 
+//--------------------------
+void ofxTCPClient::setFrameBufferSize(size_t size){
+    frameBuffer.resize(std::max(size, messageDelimiter.size() + 1));
+    resetFrameBuffer();
+}
+
+//--------------------------
+void ofxTCPClient::resetFrameBuffer(){
+    frameStart        = 0;
+    frameEnd          = 0;
+    frameScanPosition = 0;
+}
+
+//--------------------------
+bool ofxTCPClient::findFrameDelimiter(size_t & position){
+    const size_t delimiterSize = messageDelimiter.size();
+    const char * data = frameBuffer.data();
+
+    // resume where the last search stopped instead of rescanning the whole frame
+    size_t i = std::max(frameScanPosition, frameStart);
+    while(i + delimiterSize <= frameEnd){
+        const void * candidate = memchr(data + i, messageDelimiter[0], frameEnd - i - delimiterSize + 1);
+        if(candidate == nullptr) break;
+
+        i = static_cast<const char *>(candidate) - data;
+        if(memcmp(data + i, messageDelimiter.data(), delimiterSize) == 0){
+            position = i;
+            return true;
+        }
+        i++;
+    }
+
+    // a delimiter may be cut off at the end, keep its first bytes in the next search
+    frameScanPosition = std::max(frameStart, frameEnd - std::min(frameEnd, delimiterSize - 1));
+    return false;
+}
+
+//--------------------------
+bool ofxTCPClient::receiveFrame(const char *& frame, size_t & frameLength){
+    // the previous frame is consumed now, so an empty buffer can start over at 0
+    if(frameStart == frameEnd) resetFrameBuffer();
+
+    while(true){
+        size_t position;
+        if(findFrameDelimiter(position)){
+            frame             = frameBuffer.data() + frameStart;
+            frameLength       = position - frameStart;
+            frameStart        = position + messageDelimiter.size();
+            frameScanPosition = frameStart;
+            return true;
+        }
+
+        // only move data when the tail runs into the end of the buffer
+        if(frameEnd == frameBuffer.size()){
+            if(frameStart == 0){
+                ofLogWarning("ofxTCPClient") << "receiveFrame(): message larger than " << frameBuffer.size() << " bytes, dropping it";
+                resetFrameBuffer();
+            }else{
+                memmove(frameBuffer.data(), frameBuffer.data() + frameStart, frameEnd - frameStart);
+                frameEnd          -= frameStart;
+                frameScanPosition -= frameStart;
+                frameStart         = 0;
+            }
+        }
+
+        int length = receiveRawBytes(frameBuffer.data() + frameEnd, frameBuffer.size() - frameEnd);
+        if(length <= 0) return false;
+        frameEnd += length;
+    }
+}
+
 //--------------------------
 static int findDelimiter(char * data, int size, string delimiter){
     unsigned int posInDelimiter=0;
@@ -377,6 +467,11 @@ bool ofxTCPClient::isConnected(){
     return connected;
 }
 
+//--------------------------
+ofxTCPManager::SocketHandle ofxTCPClient::getSocketHandle(){
+    return TCPClient.GetSocketHandle();
+}
+
 //--------------------------
 int ofxTCPClient::getPort(){
     return port;
@@ -7,6 +7,7 @@
 #include "ofTypes.h"
 
 #define TCP_MAX_MSG_SIZE 512
+#define TCP_FRAME_BUFFER_SIZE 65536
 //#define STR_END_MSG "[/TCP]"
 //#define STR_END_MSG_LEN 6
 
@@ -49,6 +50,12 @@ class ofxTCPClient{
 		//if you are trying to send something other than just ascii strings
 		bool sendRawBytes(const char * rawBytes, const int numBytes);
 
+		//sends as much as the socket accepts without waiting, for
+		//event driven writers on a non blocking socket. returns the
+		//number of bytes sent, 0 if the socket would block and -1
+		//on error or once the connection has been closed
+		int sendRawBytesPartial(const char * rawBytes, const int numBytes);
+
         void selectInterface(std::string interface);
 		//get the message as a string
 		//this will only work with messages coming via
@@ -60,6 +67,17 @@ class ofxTCPClient{
 		//sender should send "Hello World[/TCP]"
 		std::string receive();
 
+		//framed receive, hands out the next complete message
+		//terminated by the message delimiter as a view into an
+		//internal fixed size buffer, no copies are made.
+		//the view stays valid until the next call to receiveFrame,
+		//returns false when no complete message is available yet
+		bool receiveFrame(const char *& frame, size_t & frameLength);
+
+		//capacity of the framed receive buffer, a message larger
+		//than this is dropped
+		void setFrameBufferSize(size_t size);
+
 		//no terminating string you will need to be sure
 		//you are receiving all the data by using a loop
 		std::string receiveRaw();
@@ -80,6 +98,7 @@ class ofxTCPClient{
 
 		bool isConnected();
 		int getPort();
+		ofxTCPManager::SocketHandle getSocketHandle();
 		std::string getIP();
 
 
@@ -107,4 +126,10 @@ private:
 		bool			connected;
 		std::string 	partialPrevMsg;
 		std::string		messageDelimiter;
+
+		bool findFrameDelimiter(size_t & position);
+		void resetFrameBuffer();
+
+		std::vector<char>	frameBuffer;
+		size_t			frameStart, frameEnd, frameScanPosition;
 };
@@ -203,7 +203,7 @@ bool ofxTCPManager::SelectInterface(const std::string interface) {
     free(pAddresses);
     std::cerr << "Could not find interface: " << interface << std::endl;
     return false;
-#else
+#elif defined(IP_BOUND_IF)
     int ifIndex = if_nametoindex(interface.c_str());
     
     if (ifIndex > 0) {
@@ -214,6 +214,13 @@ bool ofxTCPManager::SelectInterface(const std::string interface) {
         perror("Invalid interface name");
     }
     
+    return true;
+#else
+    // linux binds by interface name
+    if (setsockopt(m_hSocket, SOL_SOCKET, SO_BINDTODEVICE, interface.c_str(), interface.size()) < 0) {
+        std::cerr << "Failed to bind to interface: " << interface << std::endl;
+    }
+    
     return true;
 #endif
 }
@@ -60,6 +60,7 @@ SetTimeoutReceive()
 	#include <unistd.h>
 	#include <netinet/in.h>
 	#include <arpa/inet.h>
+	#include <net/if.h>
 	#include <sys/timeb.h>
 	#include <sys/types.h>
 	#include <sys/socket.h>
@@ -215,6 +216,14 @@ public:
 	// Tries to detect half open connection http://stackoverflow.com/a/283387
 	bool CheckIsConnected();
 
+	// native handle, for waiting on the socket with select/poll/epoll
+  #ifdef TARGET_WIN32
+	typedef SOCKET SocketHandle;
+  #else
+	typedef int SocketHandle;
+  #endif
+	SocketHandle GetSocketHandle() const { return m_hSocket; }
+
 
 private:
 	// private copy so this can't be copied to avoid problems with destruction
@@ -39,8 +39,12 @@ bool ofxTCPServer::setup(const ofxTCPSettings &settings){
 		ofLogError("ofxTCPServer") << "setup(): couldn't create server";
 		return false;
 	}
-	if( !TCPServer.Bind(settings.port, settings.reuse) ){
-		ofLogError("ofxTCPServer") << "setup(): couldn't bind to port " << settings.port;
+	// an address binds to that interface only, so several servers can share a port
+	bool isBound = settings.address.empty()
+		? TCPServer.Bind(settings.port, settings.reuse)
+		: TCPServer.BindToDeviceIP(settings.address, settings.port, settings.reuse);
+	if( !isBound ){
+		ofLogError("ofxTCPServer") << "setup(): couldn't bind to " << settings.address << ":" << settings.port;
 		return false;
 	}
 